@@ -5,11 +5,28 @@
 #include <stdexcept>
 #include <vector>
 #include <set>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <fstream>
 #include <string>
 
 #include "VkTest/IncludeVolk.h"
+#include "VkTest/AppSettings.h"
 #include "VkTest/GPU.h"
+#include "VkTest/Window.h"
+#include "VkTest/SubmitScheduler.h"
+#include "VkTest/ComputeQueue.h"
+#include "VkTest/DeletionQueue.h"
+#include "VkTest/ShaderWatcher.h"
+#include "VkTest/ResourceStats.h"
+#include "VkTest/CommandCapture.h"
+#include "VkTest/ResolutionScaler.h"
+#include "VkTest/ThreadPool.h"
+#include "VkTest/TaskGraph.h"
+#include "VkTest/DrawList.h"
+#include "VkTest/Arena.h"
 
 #include <GLFW/glfw3.h>
 
@@ -18,6 +35,14 @@ namespace VkTest
     class App
     {
     private:
+        // every variant is built from the same shaders and rebuilt together on hot reload
+        enum class PipelineKind
+        {
+            Opaque,
+            DepthPrepass,
+            Transparent // blends over the opaques and tests against their depth without writing it
+        };
+
     #ifdef VK_TEST_DEBUG
         static const char* m_ValidationLayers[];
 
@@ -25,45 +50,116 @@ namespace VkTest
     #endif
 
         static const std::vector<const char*> m_DeviceExtensions;
+        // there's no camera yet, view depths are measured against this
+        static constexpr float m_FarPlane = 100.0f;
 
-        GLFWwindow* m_Window;
+        AppSettings m_Settings;
+        std::unique_ptr<ThreadPool> m_ThreadPool;
+        std::vector<Window> m_Windows;
 
         VkInstance m_VkInst;
     #ifdef VK_TEST_DEBUG
         VkDebugUtilsMessengerEXT m_DebugMessenger;
     #endif
-        VkSurfaceKHR m_Surface;
 
         std::vector<GPU> m_GPUs;
         GPU* m_GPU;
 
         VkDevice m_VkDevice;
+        std::unique_ptr<ResourceStats> m_ResourceStats;
+        std::unique_ptr<CommandCapture> m_Capture;
         VkQueue m_GraphicsQueue;
         VkQueue m_PresentQueue;
-        VkSwapchainKHR m_SwapChain;
-        VkExtent2D m_SwapChainExtent;
-        std::vector<VkImage> m_SwapChainImages;
-        std::vector<VkImageView> m_SwapChainImageViews;
+        std::unique_ptr<SubmitScheduler> m_Scheduler;
+        SubmitScheduler::QueueId m_GraphicsQueueId;
+        std::unique_ptr<ComputeQueue> m_ComputeQueue;
+        DeletionQueue m_DeletionQueue;
 
         VkRenderPass m_RenderPass;
         VkPipelineLayout m_PipelineLayout;
         VkPipeline m_Pipeline;
-        std::vector<VkFramebuffer> m_Framebuffers;
+        VkPipeline m_TransparentPipeline;
+        VkPipeline m_DepthPipeline;
+
+        VkImage m_DepthImage;
+        VkDeviceMemory m_DepthMemory;
+        VkImageView m_DepthView;
+        DrawList m_DrawList;
+
+        std::mutex m_PendingPipelineMutex;
+        VkPipeline m_PendingPipeline;
+        VkPipeline m_PendingTransparentPipeline;
+        VkPipeline m_PendingDepthPipeline;
+        // after everything its callback touches, so an implicit destruction stops the watcher thread first
+        std::unique_ptr<ShaderWatcher> m_ShaderWatcher;
+
+        ResolutionScaler m_ResolutionScaler;
+        VkImage m_RenderTarget;
+        VkDeviceMemory m_RenderTargetMemory;
+        VkImageView m_RenderTargetView;
+        VkFramebuffer m_RenderTargetFramebuffer;
+        VkExtent2D m_RenderTargetExtent;
+        VkFilter m_BlitFilter;
 
         VkCommandPool m_CommandPool;
         VkCommandBuffer m_CommandBuffer;
 
+        VkSemaphore m_RenderFinishedSemaphore;
+        std::uint64_t m_LastFrameValue;
+        std::uint64_t m_FrameCount;
+        // per-frame scratch, rewound once the frame is submitted
+        Arena m_FrameArena;
+        std::uint64_t m_LastFrameHeapAllocations;
+        std::vector<TimelineWait> m_PendingComputeWaits;
+
+        void CreateWindows();
+        void CreateInstance();
+        void CreateSurfaces();
+        void FindGPUs();
         void CreateLogicalDevice();
-        void CreateSwapChain();
-        void CreateImageViews();
+        void CreateSwapChain(Window& window, const SurfaceSupport& surfaceSupport);
+        void CreateImageViews(Window& window);
         void CreateRenderPass();
-        void CreateGraphicsPipeline();
+        static void LoadShaderCode(std::vector<char>& vertShaderCode, std::vector<char>& fragShaderCode);
+        void CreateGraphicsPipeline(const std::vector<char>& vertShaderCode, const std::vector<char>& fragShaderCode);
+        VkPipeline BuildGraphicsPipeline(const std::vector<char>& vertShaderCode, const std::vector<char>& fragShaderCode, PipelineKind kind) const;
+        void StartShaderWatcher();
+        void SwapPendingPipeline();
+        void CreateRenderTarget();
+        VkFormat ChooseDepthFormat() const;
+        void CreateDepthBuffer();
         void CreateFramebuffers();
         void CreateCommandPool();
         void CreateCommandBuffer();
+        void CreateSyncObjects();
+
+        void RecordCommandBuffer();
+        void RecordWindow(const Window& window);
+        void DrawFrame();
+        void EndFrameStats();
     public:
-        App();
+        App(const AppSettings& settings);
         ~App() noexcept;
+
+        void Run();
+
+        // null unless AppSettings::collectResourceStats is set
+        inline const ResourceStats* GetResourceStats() const noexcept { return m_ResourceStats.get(); }
+        inline ThreadPool& GetThreadPool() noexcept { return *m_ThreadPool; }
+        inline Arena& GetFrameArena() noexcept { return m_FrameArena; }
+        // global operator new calls during the last frame loop iteration, zero once it has warmed up
+        inline std::uint64_t GetLastFrameHeapAllocations() const noexcept { return m_LastFrameHeapAllocations; }
+        inline ComputeQueue& GetComputeQueue() noexcept { return *m_ComputeQueue; }
+        // makes the next graphics submit wait for a compute dispatch, on a compute queue shared with
+        // graphics the scheduler drops the wait and the dispatch's own barriers order it instead
+        inline void WaitForCompute(std::uint64_t value, VkPipelineStageFlags2 stage) { m_PendingComputeWaits.push_back({m_ComputeQueue->GetTimelineSemaphore(), value, stage}); }
+        // lets a compute dispatch wait for the last submitted graphics frame
+        inline TimelineWait GetGraphicsWait(VkPipelineStageFlags2 stage) const noexcept { return {m_Scheduler->GetTimelineSemaphore(m_GraphicsQueueId), m_Scheduler->GetSubmittedValue(m_GraphicsQueueId), stage}; }
+        inline SubmitScheduler& GetScheduler() noexcept { return *m_Scheduler; }
+        inline SubmitScheduler::QueueId GetGraphicsQueueId() const noexcept { return m_GraphicsQueueId; }
+        // destroys an object once every graphics submit that could still be using it has finished
+        inline void DeferDestruction(std::function<void()> destroy) { m_DeletionQueue.Push(m_GraphicsQueueId, m_Scheduler->GetPendingValue(m_GraphicsQueueId), std::move(destroy)); }
+        inline void DeferDestruction(SubmitScheduler::QueueId queueId, std::function<void()> destroy) { m_DeletionQueue.Push(queueId, m_Scheduler->GetPendingValue(queueId), std::move(destroy)); }
     };
 }
 
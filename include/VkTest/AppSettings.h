@@ -0,0 +1,43 @@
+#ifndef VKTEST_APP_SETTINGS_H_
+#define VKTEST_APP_SETTINGS_H_
+
+#include <cstdint>
+#include <string>
+
+namespace VkTest
+{
+    struct AppSettings
+    {
+        // every window gets its own swapchain on the one device and they're presented together
+        std::uint32_t windowCount = 1;
+
+        // render into an offscreen target and scale it to hold the frame time budget
+        bool dynamicResolution = false;
+        float targetFrameTime = 16.6f; // milliseconds
+        float minRenderScale = 0.5f;
+        float maxRenderScale = 1.0f;
+
+        // lay down depth for the opaque draws first so the colour pass only shades visible fragments
+        bool depthPrepass = false;
+
+        // only matters relative to other queues in the same family
+        float graphicsQueuePriority = 1.0f;
+        float computeQueuePriority = 0.5f;
+
+        // recompile shaders/*.glsl on save and swap the rebuilt pipeline in between frames
+        bool hotReloadShaders = false;
+        std::string shaderCompiler = "glslc";
+
+        // count Vulkan objects and device memory, dumped as JSON every statsDumpInterval frames if statsPath is set
+        bool collectResourceStats = false;
+        std::string statsPath;
+        std::uint32_t statsDumpInterval = 300;
+        std::uint32_t budgetSampleInterval = 60; // frames between memory budget queries, 0 never samples
+
+        // record the command stream for VkTestReplay, captureFrames of 0 keeps going until exit
+        std::string capturePath;
+        std::uint32_t captureFrames = 0;
+    };
+}
+
+#endif
\ No newline at end of file
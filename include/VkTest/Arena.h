@@ -0,0 +1,74 @@
+#ifndef VKTEST_ARENA_H_
+#define VKTEST_ARENA_H_
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <memory_resource>
+
+namespace VkTest
+{
+    // bump allocator for short-lived data. deallocate does nothing, memory is given back all at
+    // once by Reset or an ArenaScope, and blocks are kept for reuse, so a workload that repeats
+    // stops going to the upstream resource after its first run
+    class Arena : public std::pmr::memory_resource
+    {
+    public:
+        struct Marker
+        {
+            std::size_t block;
+            std::size_t offset;
+        };
+    private:
+        struct Block
+        {
+            std::byte* data;
+            std::size_t size;
+        };
+
+        std::pmr::memory_resource* m_Upstream;
+        std::size_t m_BlockSize;
+        std::vector<Block> m_Blocks;
+        std::size_t m_Current;
+        std::size_t m_Offset;
+    protected:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+        inline void do_deallocate(void*, std::size_t, std::size_t) noexcept override {}
+        inline bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+    public:
+        Arena(std::size_t blockSize = 64 * 1024, std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()) noexcept;
+        ~Arena() noexcept;
+
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        inline void Reset() noexcept { Rewind({0, 0}); }
+        inline Marker GetMarker() const noexcept { return {m_Current, m_Offset}; }
+        inline void Rewind(Marker marker) noexcept { m_Current = marker.block; m_Offset = marker.offset; }
+        std::size_t GetCapacity() const noexcept;
+
+        // one per thread, so threads recording in parallel never share an allocator
+        static Arena& GetThreadArena();
+        // blocks every arena has taken from upstream, a steady workload shouldn't move this
+        static std::uint64_t GetUpstreamAllocationCount() noexcept;
+    };
+
+    // hands back everything allocated from the arena while it's alive
+    class ArenaScope
+    {
+    private:
+        Arena& m_Arena;
+        Arena::Marker m_Marker;
+    public:
+        inline ArenaScope(Arena& arena) noexcept : m_Arena(arena), m_Marker(arena.GetMarker()) {}
+        inline ~ArenaScope() noexcept { m_Arena.Rewind(m_Marker); }
+
+        ArenaScope(const ArenaScope&) = delete;
+        ArenaScope& operator=(const ArenaScope&) = delete;
+    };
+
+    // calls to the global operator new since startup, counted by the replacement in Arena.cpp
+    std::uint64_t GetGlobalAllocationCount() noexcept;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,180 @@
+#ifndef VKTEST_CAPTURE_FORMAT_H_
+#define VKTEST_CAPTURE_FORMAT_H_
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <type_traits>
+
+namespace VkTest
+{
+    // a capture is a header followed by records of [op (u16)][payload size (u32)][payload].
+    // handles are written as ids assigned at creation, 0 is VK_NULL_HANDLE. plain Vulkan structs
+    // are written as they are in memory, so a capture only replays on the architecture it came from
+    constexpr std::uint32_t kCaptureMagic = 0x43544B56; // "VKTC"
+    constexpr std::uint32_t kCaptureVersion = 1;
+
+    enum class CaptureOp : std::uint16_t
+    {
+        CreateImage,
+        SwapchainImage,
+        AllocateMemory,
+        BindImageMemory,
+        CreateImageView,
+        CreateShaderModule,
+        CreatePipelineLayout,
+        CreateRenderPass,
+        CreateFramebuffer,
+        CreateGraphicsPipeline,
+        CreateCommandPool,
+        AllocateCommandBuffer,
+        Destroy,
+        BeginCommandBuffer,
+        EndCommandBuffer,
+        ResetCommandBuffer,
+        BeginRenderPass,
+        NextSubpass,
+        EndRenderPass,
+        BindPipeline,
+        SetViewport,
+        SetScissor,
+        Draw,
+        PipelineBarrier,
+        BlitImage,
+        Submit,
+        Present,
+        Count
+    };
+
+    inline const char* GetCaptureOpName(CaptureOp op) noexcept
+    {
+        static const char* names[] = {
+            "vkCreateImage", "swapchain image", "vkAllocateMemory", "vkBindImageMemory", "vkCreateImageView",
+            "vkCreateShaderModule", "vkCreatePipelineLayout", "vkCreateRenderPass", "vkCreateFramebuffer", "vkCreateGraphicsPipelines",
+            "vkCreateCommandPool", "vkAllocateCommandBuffers", "vkDestroy*/vkFree*", "vkBeginCommandBuffer", "vkEndCommandBuffer",
+            "vkResetCommandBuffer", "vkCmdBeginRenderPass", "vkCmdNextSubpass", "vkCmdEndRenderPass", "vkCmdBindPipeline",
+            "vkCmdSetViewport", "vkCmdSetScissor", "vkCmdDraw", "vkCmdPipelineBarrier", "vkCmdBlitImage", "vkQueueSubmit2", "present"
+        };
+
+        static_assert(sizeof(names) / sizeof(names[0]) == static_cast<std::size_t>(CaptureOp::Count));
+        return op < CaptureOp::Count ? names[static_cast<std::size_t>(op)] : "unknown";
+    }
+
+    class CaptureWriter
+    {
+    private:
+        std::vector<std::uint8_t> m_Data;
+        std::size_t m_RecordStart;
+    public:
+        CaptureWriter() noexcept : m_RecordStart(0) {}
+
+        inline void Begin(CaptureOp op)
+        {
+            Write(static_cast<std::uint16_t>(op));
+            m_RecordStart = m_Data.size();
+            Write(std::uint32_t(0));
+        }
+
+        inline void End() noexcept
+        {
+            std::uint32_t size = static_cast<std::uint32_t>(m_Data.size() - m_RecordStart - sizeof(std::uint32_t));
+            std::memcpy(m_Data.data() + m_RecordStart, &size, sizeof(size));
+        }
+
+        template<typename T>
+        inline void Write(const T& value)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            const auto* bytes = reinterpret_cast<const std::uint8_t*>(&value);
+            m_Data.insert(m_Data.end(), bytes, bytes + sizeof(T));
+        }
+
+        // a count followed by the elements, null is written as an empty array
+        template<typename T>
+        inline void WriteArray(const T* values, std::uint32_t count)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            if (values == nullptr) { count = 0; }
+            Write(count);
+            const auto* bytes = reinterpret_cast<const std::uint8_t*>(values);
+            m_Data.insert(m_Data.end(), bytes, bytes + sizeof(T) * count);
+        }
+
+        inline void WriteString(const char* value)
+        {
+            WriteArray(value, value == nullptr ? 0 : static_cast<std::uint32_t>(std::strlen(value)));
+        }
+
+        inline const std::vector<std::uint8_t>& GetData() const noexcept { return m_Data; }
+        inline void Clear() noexcept { m_Data.clear(); }
+    };
+
+    class CaptureReader
+    {
+    private:
+        const std::uint8_t* m_Data;
+        std::size_t m_Size;
+        std::size_t m_Offset;
+
+        inline const std::uint8_t* Take(std::size_t size)
+        {
+            if (size > m_Size - m_Offset) { throw std::runtime_error("capture is truncated"); }
+
+            const std::uint8_t* bytes = m_Data + m_Offset;
+            m_Offset += size;
+            return bytes;
+        }
+    public:
+        CaptureReader(const std::uint8_t* data, std::size_t size) noexcept : m_Data(data), m_Size(size), m_Offset(0) {}
+
+        template<typename T>
+        inline T Read()
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            T value;
+            std::memcpy(&value, Take(sizeof(T)), sizeof(T));
+            return value;
+        }
+
+        // a count of elements that follow, each taking at least elementSize bytes. a count the rest
+        // of the payload can't hold is rejected here, before anything gets sized from it
+        inline std::uint32_t ReadCount(std::size_t elementSize)
+        {
+            std::uint32_t count = Read<std::uint32_t>();
+            if (count > (m_Size - m_Offset) / elementSize) { throw std::runtime_error("capture is truncated"); }
+            return count;
+        }
+
+        template<typename T>
+        inline std::vector<T> ReadArray()
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            std::uint32_t count = ReadCount(sizeof(T));
+            std::vector<T> values(count);
+            if (count > 0) { std::memcpy(values.data(), Take(sizeof(T) * count), sizeof(T) * count); }
+            return values;
+        }
+
+        inline std::string ReadString()
+        {
+            std::vector<char> characters = ReadArray<char>();
+            return std::string(characters.begin(), characters.end());
+        }
+
+        // hands out the next record's payload as its own reader
+        inline CaptureReader ReadRecord(CaptureOp& op)
+        {
+            op = static_cast<CaptureOp>(Read<std::uint16_t>());
+            if (op >= CaptureOp::Count) { throw std::runtime_error("capture contains an unknown op"); }
+
+            std::uint32_t size = Read<std::uint32_t>();
+            return CaptureReader(Take(size), size);
+        }
+
+        inline bool IsAtEnd() const noexcept { return m_Offset == m_Size; }
+    };
+}
+
+#endif
\ No newline at end of file
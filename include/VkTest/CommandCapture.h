@@ -0,0 +1,80 @@
+#ifndef VKTEST_COMMAND_CAPTURE_H_
+#define VKTEST_COMMAND_CAPTURE_H_
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <map>
+#include <utility>
+#include <fstream>
+#include <mutex>
+
+#include "VkTest/IncludeVolk.h"
+#include "VkTest/CaptureFormat.h"
+
+namespace VkTest
+{
+    // writes resource creation and every recorded command into a capture file for VkTestReplay.
+    // like ResourceStats it swaps volk's device function pointers for wrappers, the two can be
+    // installed together as long as they're uninstalled in reverse order. only one capture can be
+    // installed at a time
+    class CommandCapture
+    {
+    public:
+        // swapchains aren't recorded, their images are replayed as plain images of the same description
+        struct Swapchain
+        {
+            VkFormat format;
+            VkExtent2D extent;
+            VkImageUsageFlags usage;
+            std::vector<std::uint64_t> images;
+        };
+    private:
+        VkPhysicalDeviceMemoryProperties m_MemoryProperties;
+        std::ofstream m_File;
+        std::uint32_t m_FrameLimit;
+        std::uint32_t m_FrameCount;
+        bool m_Active;
+
+        std::mutex m_Mutex;
+        CaptureWriter m_Writer;
+        std::map<std::pair<VkObjectType, std::uint64_t>, std::uint64_t> m_Ids;
+        std::uint64_t m_NextId;
+        std::map<std::uint64_t, Swapchain> m_Swapchains;
+
+        void WriteToFile() noexcept;
+        void Close() noexcept;
+    public:
+        // frameLimit of 0 keeps capturing until the capture is destroyed
+        CommandCapture(VkPhysicalDevice physicalDevice, const std::string& path, std::uint32_t frameLimit);
+        ~CommandCapture() noexcept;
+
+        CommandCapture(const CommandCapture&) = delete;
+        CommandCapture& operator=(const CommandCapture&) = delete;
+
+        void Install();
+        void Uninstall() noexcept;
+        void Stop() noexcept;
+
+        // the rest is for the hooks. Lock returns false without locking once the capture has stopped,
+        // the writer, id and swapchain lookups are only valid between Lock and Unlock
+        bool Lock();
+        void Unlock() noexcept;
+        bool IsActive() noexcept;
+        void OnPresent() noexcept;
+
+        std::uint64_t AssignId(VkObjectType type, std::uint64_t handle);
+        std::uint64_t GetId(VkObjectType type, std::uint64_t handle) const noexcept;
+        std::uint64_t ReleaseId(VkObjectType type, std::uint64_t handle) noexcept;
+        Swapchain* FindSwapchain(std::uint64_t swapchain) noexcept;
+
+        void AddSwapchain(std::uint64_t swapchain, const Swapchain& info);
+        std::vector<std::uint64_t> RemoveSwapchain(std::uint64_t swapchain);
+
+        inline CaptureWriter& GetWriter() noexcept { return m_Writer; }
+        inline VkMemoryPropertyFlags GetMemoryPropertyFlags(std::uint32_t memoryType) const noexcept { return m_MemoryProperties.memoryTypes[memoryType].propertyFlags; }
+    };
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,50 @@
+#ifndef VKTEST_COMPUTE_QUEUE_H_
+#define VKTEST_COMPUTE_QUEUE_H_
+
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include <deque>
+#include <functional>
+
+#include "VkTest/IncludeVolk.h"
+#include "VkTest/SubmitScheduler.h"
+
+namespace VkTest
+{
+    // dispatches go through the scheduler and complete when the compute queue's timeline
+    // reaches the returned value. anything shared with graphics needs
+    // VK_SHARING_MODE_CONCURRENT when the queue families differ. without a second queue the
+    // dispatches go into the graphics stream and are ordered against it with barriers instead
+    class ComputeQueue
+    {
+    private:
+        struct InFlight
+        {
+            VkCommandBuffer commandBuffer;
+            std::uint64_t value;
+        };
+
+        VkDevice m_Device;
+        SubmitScheduler& m_Scheduler;
+        SubmitScheduler::QueueId m_QueueId;
+        VkCommandPool m_CommandPool;
+        std::deque<InFlight> m_InFlight;
+        std::vector<VkCommandBuffer> m_FreeCommandBuffers;
+
+        VkCommandBuffer AcquireCommandBuffer();
+    public:
+        ComputeQueue(VkDevice device, SubmitScheduler& scheduler, SubmitScheduler::QueueId queueId, std::uint32_t familyIndex);
+        ~ComputeQueue() noexcept;
+
+        ComputeQueue(const ComputeQueue&) = delete;
+        ComputeQueue& operator=(const ComputeQueue&) = delete;
+
+        std::uint64_t Dispatch(const std::function<void(VkCommandBuffer)>& record, const std::vector<TimelineWait>& waits = {});
+
+        inline SubmitScheduler::QueueId GetQueueId() const noexcept { return m_QueueId; }
+        inline VkSemaphore GetTimelineSemaphore() const noexcept { return m_Scheduler.GetTimelineSemaphore(m_QueueId); }
+    };
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,43 @@
+#ifndef VKTEST_DELETION_QUEUE_H_
+#define VKTEST_DELETION_QUEUE_H_
+
+#include <cstdint>
+#include <vector>
+#include <functional>
+#include <optional>
+
+#include "VkTest/SubmitScheduler.h"
+
+namespace VkTest
+{
+    // holds on to destruction of objects until the queue that last used them has passed
+    // the given timeline value, so swapping things at runtime never needs vkDeviceWaitIdle
+    class DeletionQueue
+    {
+    private:
+        struct Entry
+        {
+            SubmitScheduler::QueueId queueId;
+            std::uint64_t value;
+            std::function<void()> destroy;
+        };
+
+        std::vector<Entry> m_Entries;
+        // per queue, filled lazily by Collect and kept around so it doesn't allocate every frame
+        std::vector<std::optional<std::uint64_t>> m_CompletedValues;
+    public:
+        DeletionQueue() noexcept = default;
+        ~DeletionQueue() noexcept;
+
+        DeletionQueue(const DeletionQueue&) = delete;
+        DeletionQueue& operator=(const DeletionQueue&) = delete;
+
+        void Push(SubmitScheduler::QueueId queueId, std::uint64_t value, std::function<void()> destroy);
+        void Collect(const SubmitScheduler& scheduler);
+        void Flush() noexcept;
+
+        inline std::size_t GetSize() const noexcept { return m_Entries.size(); }
+    };
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,62 @@
+#ifndef VKTEST_DRAW_LIST_H_
+#define VKTEST_DRAW_LIST_H_
+
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "VkTest/ThreadPool.h"
+
+namespace VkTest
+{
+    struct Draw
+    {
+        std::uint16_t pipeline; // index into the renderer's pipeline table
+        std::uint16_t material;
+        bool transparent;
+        float viewDepth; // distance from the camera along the view direction
+        std::uint32_t vertexCount;
+        std::uint32_t instanceCount;
+        std::uint32_t firstVertex;
+        std::uint32_t firstInstance;
+    };
+
+    // a frame's draws ordered by 64-bit keys, most significant bits first:
+    //   opaque:      layer (2) | pipeline (14) | material (16) | depth (24) | unused (8)
+    //   transparent: layer (2) | inverted depth (24) | pipeline (14) | material (16) | unused (8)
+    // opaques come first, grouped by state and front to back within a group, then transparents back to front
+    class DrawList
+    {
+    private:
+        struct SortEntry
+        {
+            std::uint64_t key;
+            std::uint32_t index;
+        };
+
+        float m_FarPlane;
+        std::vector<Draw> m_Draws;
+        std::vector<SortEntry> m_Entries;
+        std::vector<SortEntry> m_Scratch;
+        std::vector<std::uint32_t> m_Histograms;
+        std::size_t m_OpaqueCount;
+    public:
+        DrawList(float farPlane) noexcept;
+
+        void Clear() noexcept;
+        void Add(const Draw& draw);
+        // parallel LSD radix sort, one pass per byte of the key. bytes that every key shares are skipped
+        void Sort(ThreadPool& pool);
+
+        // throws if the pipeline index doesn't fit in its 14 bits
+        static std::uint64_t MakeKey(const Draw& draw, float farPlane);
+
+        // in sorted order once Sort has run
+        inline const Draw& operator[](std::size_t i) const noexcept { return m_Draws[m_Entries[i].index]; }
+        inline std::size_t GetSize() const noexcept { return m_Entries.size(); }
+        // sorted opaques are the first GetOpaqueCount() draws
+        inline std::size_t GetOpaqueCount() const noexcept { return m_OpaqueCount; }
+    };
+}
+
+#endif
\ No newline at end of file
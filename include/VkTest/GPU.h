@@ -10,6 +10,7 @@
 #include <algorithm>
 
 #include "VkTest/IncludeVolk.h"
+#include "VkTest/SurfaceSupport.h"
 
 #include <GLFW/glfw3.h>
 
@@ -20,25 +21,41 @@ namespace VkTest
         friend std::ostream& operator<<(std::ostream&,const GPU&);
     private:
         VkPhysicalDevice m_PhysicalDevice;
-        VkSurfaceKHR m_Surface;
+        std::vector<SurfaceSupport> m_Surfaces;
         VkPhysicalDeviceProperties m_DeviceProperties;
+        VkPhysicalDeviceMemoryProperties m_MemoryProperties;
         std::vector<VkQueueFamilyProperties> m_QueueFamilyProperties;
         std::vector<VkExtensionProperties> m_ExtensionProperties;
 
         std::optional<std::uint32_t> m_GraphicsQueueIndex;
         std::optional<std::uint32_t> m_PresentQueueIndex;
+        std::optional<std::uint32_t> m_ComputeQueueIndex;
 
         bool m_HasSwapChainSupport;
-        VkSurfaceCapabilitiesKHR m_SurfaceCapabilities;
-        std::vector<VkSurfaceFormatKHR> m_SurfaceFormats;
-        std::vector<VkPresentModeKHR> m_PresentModes;
-        std::optional<VkSurfaceFormatKHR> m_SurfaceFormat;
-        std::optional<VkPresentModeKHR> m_PresentMode;
-        VkSwapchainKHR m_SwapChain;
+        bool m_HasTimelineSemaphore;
+        bool m_HasSynchronization2;
     public:
-        inline GPU(VkPhysicalDevice pd, VkSurfaceKHR surf) noexcept : m_PhysicalDevice(pd), m_Surface(surf)
+        inline GPU(VkPhysicalDevice pd, const std::vector<VkSurfaceKHR>& surfaces) noexcept : m_PhysicalDevice(pd), m_HasSwapChainSupport(false), m_HasTimelineSemaphore(false), m_HasSynchronization2(false)
         {
             vkGetPhysicalDeviceProperties(m_PhysicalDevice, &m_DeviceProperties);
+
+            // the per-version feature structs can only be chained on devices that report that version
+            if (m_DeviceProperties.apiVersion >= VK_API_VERSION_1_2)
+            {
+                VkPhysicalDeviceVulkan13Features vulkan13Features{};
+                vulkan13Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+                VkPhysicalDeviceVulkan12Features vulkan12Features{};
+                vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+                vulkan12Features.pNext = m_DeviceProperties.apiVersion >= VK_API_VERSION_1_3 ? &vulkan13Features : nullptr;
+                VkPhysicalDeviceFeatures2 features{};
+                features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+                features.pNext = &vulkan12Features;
+                vkGetPhysicalDeviceFeatures2(m_PhysicalDevice, &features);
+                m_HasTimelineSemaphore = vulkan12Features.timelineSemaphore == VK_TRUE;
+                m_HasSynchronization2 = vulkan13Features.synchronization2 == VK_TRUE;
+            }
+
+            vkGetPhysicalDeviceMemoryProperties(m_PhysicalDevice, &m_MemoryProperties);
             std::uint32_t enumSize;
             vkGetPhysicalDeviceQueueFamilyProperties(m_PhysicalDevice, &enumSize, NULL);
             m_QueueFamilyProperties.resize(enumSize);
@@ -53,53 +70,58 @@ namespace VkTest
                 }
             }
 
+            // prefer a compute-only family, those are the ones that actually run alongside graphics
             for (std::uint32_t i = 0; i < enumSize; ++i)
             {
-                VkBool32 val;
-                vkGetPhysicalDeviceSurfaceSupportKHR(m_PhysicalDevice, i, m_Surface, &val);
-
-                if (val == VK_TRUE)
+                if ((m_QueueFamilyProperties[i].queueFlags & VK_QUEUE_COMPUTE_BIT) && !(m_QueueFamilyProperties[i].queueFlags & VK_QUEUE_GRAPHICS_BIT))
                 {
-                    m_PresentQueueIndex = i;
+                    m_ComputeQueueIndex = i;
                     break;
                 }
             }
 
-            vkEnumerateDeviceExtensionProperties(m_PhysicalDevice, NULL, &enumSize, NULL);
-            m_ExtensionProperties.resize(enumSize);
-            vkEnumerateDeviceExtensionProperties(m_PhysicalDevice, NULL, &enumSize, m_ExtensionProperties.data());
+            if (!m_ComputeQueueIndex.has_value() && m_GraphicsQueueIndex.has_value())
+            {
+                // graphics families are required to support compute
+                m_ComputeQueueIndex = m_GraphicsQueueIndex;
+            }
 
-            for (auto& extension : m_ExtensionProperties)
+            for (VkSurfaceKHR surface : surfaces)
             {
-                if (std::strcmp(extension.extensionName, VK_KHR_SWAPCHAIN_EXTENSION_NAME) == 0)
-                {
-                    m_HasSwapChainSupport = true;
-                    break;
-                }
+                m_Surfaces.emplace_back(m_PhysicalDevice, surface, enumSize);
             }
-            
-            vkGetPhysicalDeviceSurfaceCapabilitiesKHR(m_PhysicalDevice, m_Surface, &m_SurfaceCapabilities);
-            vkGetPhysicalDeviceSurfaceFormatsKHR(m_PhysicalDevice, m_Surface, &enumSize, NULL);
-            m_SurfaceFormats.resize(enumSize);
-            vkGetPhysicalDeviceSurfaceFormatsKHR(m_PhysicalDevice, m_Surface, &enumSize, m_SurfaceFormats.data());
-            vkGetPhysicalDeviceSurfacePresentModesKHR(m_PhysicalDevice, m_Surface, &enumSize, NULL);
-            m_PresentModes.resize(enumSize);
-            vkGetPhysicalDeviceSurfacePresentModesKHR(m_PhysicalDevice, m_Surface, &enumSize, m_PresentModes.data());
-
-            for (const auto& surfaceFormat : m_SurfaceFormats)
+
+            // every swapchain goes out in the same vkQueuePresentKHR, so the family has to reach all surfaces
+            auto canPresentToAll = [this](std::uint32_t familyIndex)
             {
-                if (surfaceFormat.format == VK_FORMAT_B8G8R8A8_SRGB && surfaceFormat.colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR)
+                return std::all_of(m_Surfaces.begin(), m_Surfaces.end(), [familyIndex](const SurfaceSupport& surface) { return surface.CanPresentFrom(familyIndex); });
+            };
+
+            if (m_GraphicsQueueIndex.has_value() && canPresentToAll(m_GraphicsQueueIndex.value()))
+            {
+                m_PresentQueueIndex = m_GraphicsQueueIndex;
+            }
+            else
+            {
+                for (std::uint32_t i = 0; i < enumSize; ++i)
                 {
-                    m_SurfaceFormat = surfaceFormat;
-                    break;
+                    if (canPresentToAll(i))
+                    {
+                        m_PresentQueueIndex = i;
+                        break;
+                    }
                 }
             }
 
-            for (const auto& presentMode : m_PresentModes)
+            vkEnumerateDeviceExtensionProperties(m_PhysicalDevice, NULL, &enumSize, NULL);
+            m_ExtensionProperties.resize(enumSize);
+            vkEnumerateDeviceExtensionProperties(m_PhysicalDevice, NULL, &enumSize, m_ExtensionProperties.data());
+
+            for (auto& extension : m_ExtensionProperties)
             {
-                if (presentMode == VK_PRESENT_MODE_MAILBOX_KHR)
+                if (std::strcmp(extension.extensionName, VK_KHR_SWAPCHAIN_EXTENSION_NAME) == 0)
                 {
-                    m_PresentMode = VK_PRESENT_MODE_MAILBOX_KHR;
+                    m_HasSwapChainSupport = true;
                     break;
                 }
             }
@@ -113,12 +135,46 @@ namespace VkTest
         inline std::uint32_t GetGraphicsQueueIndex() const noexcept { return m_GraphicsQueueIndex.value(); }
         inline bool HasPresentQueue() const noexcept { return m_PresentQueueIndex.has_value(); }
         inline std::uint32_t GetPresentQueueIndex() const noexcept { return m_PresentQueueIndex.value(); }
+        inline bool HasComputeQueue() const noexcept { return m_ComputeQueueIndex.has_value(); }
+        inline std::uint32_t GetComputeQueueIndex() const noexcept { return m_ComputeQueueIndex.value(); }
+        inline bool HasDedicatedComputeQueue() const noexcept { return HasComputeQueue() && GetComputeQueueIndex() != m_GraphicsQueueIndex; }
+        inline std::uint32_t GetQueueCount(std::uint32_t familyIndex) const noexcept { return m_QueueFamilyProperties[familyIndex].queueCount; }
+        inline bool HasExtension(const char* name) const noexcept
+        {
+            return std::any_of(m_ExtensionProperties.begin(), m_ExtensionProperties.end(), [name](const VkExtensionProperties& extension) { return std::strcmp(extension.extensionName, name) == 0; });
+        }
+
         inline bool HasSwapChainSupport() const noexcept { return m_HasSwapChainSupport; }
-        inline const VkSurfaceCapabilitiesKHR& GetSurfaceCapabilities() const noexcept { return m_SurfaceCapabilities; }
-        inline const VkSurfaceFormatKHR& GetSurfaceFormat() const noexcept { return m_SurfaceFormat.value(); }
-        inline const VkPresentModeKHR& GetPresentMode() const noexcept { return m_PresentMode.value(); }
+        inline bool HasTimelineSemaphore() const noexcept { return m_HasTimelineSemaphore; }
+        inline bool HasSynchronization2() const noexcept { return m_HasSynchronization2; }
+        inline const SurfaceSupport& GetSurface(std::size_t index) const noexcept { return m_Surfaces[index]; }
+        inline std::size_t GetSurfaceCount() const noexcept { return m_Surfaces.size(); }
+
+        inline std::optional<std::uint32_t> FindMemoryType(std::uint32_t typeBits, VkMemoryPropertyFlags properties) const noexcept
+        {
+            for (std::uint32_t i = 0; i < m_MemoryProperties.memoryTypeCount; ++i)
+            {
+                if ((typeBits & (1u << i)) && (m_MemoryProperties.memoryTypes[i].propertyFlags & properties) == properties)
+                {
+                    return i;
+                }
+            }
+
+            return std::nullopt;
+        }
 
-        inline bool IsDeviceSuitable() const noexcept { return HasGraphicsQueue() && HasPresentQueue() && HasSwapChainSupport() && m_SurfaceFormat.has_value() && m_PresentMode.has_value(); }
+        inline VkFormatFeatureFlags GetOptimalTilingFeatures(VkFormat format) const noexcept
+        {
+            VkFormatProperties formatProperties;
+            vkGetPhysicalDeviceFormatProperties(m_PhysicalDevice, format, &formatProperties);
+            return formatProperties.optimalTilingFeatures;
+        }
+
+        inline bool IsDeviceSuitable() const noexcept
+        {
+            return HasGraphicsQueue() && HasPresentQueue() && HasSwapChainSupport() && HasTimelineSemaphore() && HasSynchronization2() &&
+                std::all_of(m_Surfaces.begin(), m_Surfaces.end(), [](const SurfaceSupport& surface) { return surface.IsSuitable(); });
+        }
     };
 
     std::ostream& operator<<(std::ostream&,const GPU&);
@@ -0,0 +1,112 @@
+#ifndef VKTEST_REPLAYER_H_
+#define VKTEST_REPLAYER_H_
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <array>
+#include <unordered_map>
+#include <optional>
+#include <chrono>
+#include <ostream>
+
+#include "VkTest/IncludeVolk.h"
+#include "VkTest/CaptureFormat.h"
+#include "VkTest/GPU.h"
+
+namespace VkTest
+{
+    struct ReplayTiming
+    {
+        std::uint64_t count = 0;
+        double totalMs = 0.0;
+        double maxMs = 0.0;
+
+        inline void Add(double ms) noexcept
+        {
+            ++count;
+            totalMs += ms;
+            maxMs = ms > maxMs ? ms : maxMs;
+        }
+    };
+
+    // plays a capture back on its own device as fast as the driver takes it and times every call.
+    // nothing is presented and all work goes to one queue in submission order, command buffers are
+    // only waited on when the capture records into them again, and that time is kept separate
+    class Replayer
+    {
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        template<typename Handle>
+        using HandleMap = std::unordered_map<std::uint64_t, Handle>;
+
+        struct Memory
+        {
+            VkDeviceSize size;
+            VkMemoryPropertyFlags properties;
+            VkDeviceMemory memory;
+        };
+
+        struct CommandBuffer
+        {
+            VkCommandBuffer handle;
+            std::uint64_t pool;
+            std::uint64_t submittedValue;
+        };
+
+        VkInstance m_Instance;
+        std::optional<GPU> m_GPU;
+        VkDevice m_Device;
+        VkQueue m_Queue;
+        VkSemaphore m_Timeline;
+        std::uint64_t m_SubmittedValue;
+
+        // captured ids are unique across object types
+        HandleMap<VkImage> m_Images;
+        HandleMap<VkDeviceMemory> m_ImageMemory; // backs the images that stand in for swapchain images
+        HandleMap<Memory> m_Memory;
+        HandleMap<VkImageView> m_ImageViews;
+        HandleMap<VkShaderModule> m_ShaderModules;
+        HandleMap<VkPipelineLayout> m_PipelineLayouts;
+        HandleMap<VkRenderPass> m_RenderPasses;
+        HandleMap<VkFramebuffer> m_Framebuffers;
+        HandleMap<VkPipeline> m_Pipelines;
+        HandleMap<VkCommandPool> m_CommandPools;
+        HandleMap<CommandBuffer> m_CommandBuffers;
+
+        std::array<ReplayTiming, static_cast<std::size_t>(CaptureOp::Count)> m_Timings;
+        ReplayTiming m_FrameTiming;
+        ReplayTiming m_WaitTiming;
+        std::uint64_t m_FrameCount;
+        double m_SetupMs; // the first frame, which also creates everything
+        double m_FrameWaitMs;
+        Clock::time_point m_FrameStart;
+
+        void CreateInstance();
+        void CreateDevice(std::optional<std::uint32_t> deviceIndex);
+
+        void Execute(CaptureOp op, CaptureReader& record);
+        void CreateGraphicsPipeline(CaptureReader& record);
+        void CreateRenderPass(CaptureReader& record);
+        void Destroy(VkObjectType type, std::uint64_t id);
+        void EndFrame();
+
+        VkDeviceMemory AllocateMemory(VkDeviceSize size, std::uint32_t typeBits, VkMemoryPropertyFlags properties);
+        CommandBuffer& GetCommandBuffer(std::uint64_t id);
+        void Wait(std::uint64_t value);
+    public:
+        // picks a discrete GPU unless deviceIndex says otherwise
+        Replayer(std::optional<std::uint32_t> deviceIndex);
+        ~Replayer() noexcept;
+
+        Replayer(const Replayer&) = delete;
+        Replayer& operator=(const Replayer&) = delete;
+
+        void Replay(const std::vector<std::uint8_t>& capture);
+        void PrintReport(std::ostream& os) const;
+    };
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,37 @@
+#ifndef VKTEST_RESOLUTION_SCALER_H_
+#define VKTEST_RESOLUTION_SCALER_H_
+
+#include <cstdint>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+
+#include "VkTest/IncludeVolk.h"
+
+namespace VkTest
+{
+    class ResolutionScaler
+    {
+    private:
+        float m_TargetFrameTime;
+        float m_MinScale;
+        float m_MaxScale;
+        float m_Scale;
+        float m_AverageFrameTime;
+        std::chrono::steady_clock::time_point m_LastFrame;
+        bool m_HasLastFrame;
+    public:
+        ResolutionScaler(float targetFrameTime, float minScale, float maxScale) noexcept;
+
+        // measures the time since the last call and feeds it to AddFrameTime
+        void Update() noexcept;
+        // frame time in milliseconds
+        void AddFrameTime(float frameTime) noexcept;
+        VkExtent2D GetRenderExtent(VkExtent2D fullExtent) const noexcept;
+
+        inline float GetScale() const noexcept { return m_Scale; }
+        inline float GetAverageFrameTime() const noexcept { return m_AverageFrameTime; }
+    };
+}
+
+#endif
\ No newline at end of file
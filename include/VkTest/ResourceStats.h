@@ -0,0 +1,128 @@
+#ifndef VKTEST_RESOURCE_STATS_H_
+#define VKTEST_RESOURCE_STATS_H_
+
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <array>
+#include <string>
+#include <mutex>
+
+#include "VkTest/IncludeVolk.h"
+
+namespace VkTest
+{
+    enum class MemoryCategory : std::uint32_t
+    {
+        Other,
+        RenderTarget,
+        Buffer,
+        Staging,
+        Count
+    };
+
+    struct StatCounter
+    {
+        std::uint64_t current = 0;
+        std::uint64_t peak = 0;
+
+        inline void Add(std::uint64_t amount) noexcept { current += amount; peak = current > peak ? current : peak; }
+        // clamps at zero and returns false if more was released than was ever added
+        inline bool Subtract(std::uint64_t amount) noexcept
+        {
+            bool inRange = amount <= current;
+            current -= inRange ? amount : current;
+            return inRange;
+        }
+    };
+
+    struct ResourceSnapshot
+    {
+        std::uint64_t frame = 0;
+        std::map<VkObjectType, StatCounter> objects;
+        std::vector<StatCounter> heapBytes;
+        std::vector<StatCounter> memoryTypeBytes;
+        std::array<StatCounter, static_cast<std::size_t>(MemoryCategory::Count)> categoryBytes;
+
+        // totals for the last finished frame
+        std::uint64_t frameObjectsCreated = 0;
+        std::uint64_t frameAllocations = 0;
+        std::uint64_t frameAllocatedBytes = 0;
+        std::uint64_t frameHeapAllocations = 0; // global operator new, not device memory, and a frame behind the rest
+
+        bool hasBudget = false;
+        std::vector<VkDeviceSize> heapBudget;
+        std::vector<VkDeviceSize> heapUsage;
+    };
+
+    // counts live Vulkan objects and device memory by swapping volk's device function pointers
+    // for thin wrappers, so every create/destroy in the process is seen without touching call sites.
+    // only the object types named in GetObjectTypeName are hooked, anything else (pipeline caches,
+    // extension objects) isn't counted. only one instance can be installed at a time
+    class ResourceStats
+    {
+    public:
+        // tags allocations made on this thread while it's alive
+        class CategoryScope
+        {
+        private:
+            MemoryCategory m_Previous;
+        public:
+            CategoryScope(MemoryCategory category) noexcept;
+            ~CategoryScope() noexcept;
+        };
+    private:
+        struct Allocation
+        {
+            std::uint32_t memoryType;
+            VkDeviceSize size;
+            MemoryCategory category;
+        };
+
+        VkPhysicalDevice m_PhysicalDevice;
+        VkPhysicalDeviceMemoryProperties m_MemoryProperties;
+        bool m_HasBudget;
+
+        mutable std::mutex m_Mutex;
+        ResourceSnapshot m_Snapshot;
+        std::unordered_map<VkDeviceMemory, Allocation> m_Allocations;
+        std::unordered_map<VkCommandPool, std::uint64_t> m_PoolCommandBuffers;
+        std::unordered_map<VkDescriptorPool, std::uint64_t> m_PoolDescriptorSets;
+        std::uint64_t m_FrameObjectsCreated;
+        std::uint64_t m_FrameAllocations;
+        std::uint64_t m_FrameAllocatedBytes;
+
+        void SampleBudget();
+    public:
+        ResourceStats(VkPhysicalDevice physicalDevice, bool hasMemoryBudget);
+        ~ResourceStats() noexcept;
+
+        ResourceStats(const ResourceStats&) = delete;
+        ResourceStats& operator=(const ResourceStats&) = delete;
+
+        void Install();
+        void Uninstall() noexcept;
+
+        void OnCreate(VkObjectType type, std::uint64_t count = 1);
+        void OnDestroy(VkObjectType type, std::uint64_t count = 1);
+        void OnAllocateCommandBuffers(VkCommandPool pool, std::uint64_t count);
+        void OnFreeCommandBuffers(VkCommandPool pool, std::uint64_t count);
+        void OnDestroyCommandPool(VkCommandPool pool);
+        void OnAllocateDescriptorSets(VkDescriptorPool pool, std::uint64_t count);
+        void OnFreeDescriptorSets(VkDescriptorPool pool, std::uint64_t count);
+        void OnResetDescriptorPool(VkDescriptorPool pool, bool destroyed);
+        void OnAllocate(VkDeviceMemory memory, std::uint32_t memoryType, VkDeviceSize size);
+        void OnFree(VkDeviceMemory memory);
+
+        void EndFrame(bool sampleBudget, std::uint64_t heapAllocations);
+        ResourceSnapshot GetSnapshot() const;
+        std::string ToJson() const;
+        bool WriteJson(const std::string& path) const;
+
+        static const char* GetObjectTypeName(VkObjectType type) noexcept;
+    };
+}
+
+#endif
\ No newline at end of file
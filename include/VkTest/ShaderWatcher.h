@@ -0,0 +1,36 @@
+#ifndef VKTEST_SHADER_WATCHER_H_
+#define VKTEST_SHADER_WATCHER_H_
+
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include <string>
+#include <functional>
+#include <thread>
+
+namespace VkTest
+{
+    // watches a directory for edited GLSL, recompiles it to SPIR-V next to the source and
+    // reports the rebuilt shaders. everything, including the callback, runs on the watcher thread
+    class ShaderWatcher
+    {
+    private:
+        std::string m_Directory;
+        std::string m_Compiler;
+        std::function<void(const std::vector<std::string>&)> m_OnRebuilt;
+        int m_InotifyFd;
+        int m_WakeFd;
+        std::thread m_Thread;
+
+        void Watch();
+        bool Compile(const std::string& name) const;
+    public:
+        ShaderWatcher(const std::string& directory, const std::string& compiler, std::function<void(const std::vector<std::string>&)> onRebuilt);
+        ~ShaderWatcher() noexcept;
+
+        ShaderWatcher(const ShaderWatcher&) = delete;
+        ShaderWatcher& operator=(const ShaderWatcher&) = delete;
+    };
+}
+
+#endif
\ No newline at end of file
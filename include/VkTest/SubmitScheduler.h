@@ -0,0 +1,80 @@
+#ifndef VKTEST_SUBMIT_SCHEDULER_H_
+#define VKTEST_SUBMIT_SCHEDULER_H_
+
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include <memory_resource>
+
+#include "VkTest/IncludeVolk.h"
+#include "VkTest/Arena.h"
+
+namespace VkTest
+{
+    // value is ignored for binary semaphores
+    struct TimelineWait
+    {
+        VkSemaphore semaphore;
+        std::uint64_t value;
+        VkPipelineStageFlags2 stage;
+    };
+
+    struct SubmitBatch
+    {
+        SubmitBatch(std::pmr::memory_resource* memory = std::pmr::get_default_resource()) : commandBuffers(memory), waits(memory), signals(memory) {}
+
+        std::pmr::vector<VkCommandBuffer> commandBuffers;
+        std::pmr::vector<TimelineWait> waits;
+        std::pmr::vector<TimelineWait> signals;
+    };
+
+    // collects batches from every producer and hands each queue all of its work in one
+    // vkQueueSubmit2 per flush. every queue owns a timeline semaphore that's bumped once
+    // per flush, so completion is tracked with a single value instead of a fence per submit.
+    // waits on the target queue's own timeline are dropped, work on one queue is ordered by barriers
+    class SubmitScheduler
+    {
+    public:
+        using QueueId = std::uint32_t;
+    private:
+        struct Queue
+        {
+            VkQueue queue;
+            VkSemaphore timeline;
+            std::uint64_t submittedValue;
+            std::uint32_t producers;
+            std::vector<SubmitBatch> pending;
+        };
+
+        VkDevice m_Device;
+        std::vector<Queue> m_Queues;
+        std::uint32_t m_LastSubmitCount;
+        Arena m_Arena;
+    public:
+        SubmitScheduler(VkDevice device) noexcept;
+        ~SubmitScheduler() noexcept;
+
+        SubmitScheduler(const SubmitScheduler&) = delete;
+        SubmitScheduler& operator=(const SubmitScheduler&) = delete;
+
+        QueueId AddQueue(VkQueue queue);
+        void Enqueue(QueueId id, SubmitBatch batch);
+        void Flush();
+
+        std::uint64_t GetCompletedValue(QueueId id) const;
+        void Wait(QueueId id, std::uint64_t value) const;
+        void WaitIdle() const;
+
+        // the value the queue reaches once everything enqueued so far has executed
+        inline std::uint64_t GetPendingValue(QueueId id) const noexcept { return m_Queues[id].submittedValue + 1; }
+        inline std::uint64_t GetSubmittedValue(QueueId id) const noexcept { return m_Queues[id].submittedValue; }
+        inline VkSemaphore GetTimelineSemaphore(QueueId id) const noexcept { return m_Queues[id].timeline; }
+        // more than one AddQueue handed out this id, the producers can't rely on timeline waits between each other
+        inline bool IsShared(QueueId id) const noexcept { return m_Queues[id].producers > 1; }
+        inline std::uint32_t GetLastSubmitCount() const noexcept { return m_LastSubmitCount; }
+        // released by the flush that submits them, so batches built from this have to be enqueued before the next Flush
+        inline std::pmr::memory_resource* GetBatchMemory() noexcept { return &m_Arena; }
+    };
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,74 @@
+#ifndef VKTEST_SURFACE_SUPPORT_H_
+#define VKTEST_SURFACE_SUPPORT_H_
+
+#include <cstdint>
+#include <vector>
+#include <optional>
+
+#include "VkTest/IncludeVolk.h"
+
+namespace VkTest
+{
+    // what one physical device can do with one surface
+    class SurfaceSupport
+    {
+    private:
+        VkPhysicalDevice m_PhysicalDevice;
+        VkSurfaceKHR m_Surface;
+        std::vector<bool> m_PresentFamilies;
+        VkSurfaceCapabilitiesKHR m_SurfaceCapabilities;
+        std::vector<VkSurfaceFormatKHR> m_SurfaceFormats;
+        std::vector<VkPresentModeKHR> m_PresentModes;
+        std::optional<VkSurfaceFormatKHR> m_SurfaceFormat;
+        std::optional<VkPresentModeKHR> m_PresentMode;
+    public:
+        inline SurfaceSupport(VkPhysicalDevice pd, VkSurfaceKHR surf, std::uint32_t queueFamilyCount) noexcept : m_PhysicalDevice(pd), m_Surface(surf)
+        {
+            m_PresentFamilies.resize(queueFamilyCount);
+
+            for (std::uint32_t i = 0; i < queueFamilyCount; ++i)
+            {
+                VkBool32 val;
+                vkGetPhysicalDeviceSurfaceSupportKHR(m_PhysicalDevice, i, m_Surface, &val);
+                m_PresentFamilies[i] = val == VK_TRUE;
+            }
+
+            std::uint32_t enumSize;
+            vkGetPhysicalDeviceSurfaceCapabilitiesKHR(m_PhysicalDevice, m_Surface, &m_SurfaceCapabilities);
+            vkGetPhysicalDeviceSurfaceFormatsKHR(m_PhysicalDevice, m_Surface, &enumSize, NULL);
+            m_SurfaceFormats.resize(enumSize);
+            vkGetPhysicalDeviceSurfaceFormatsKHR(m_PhysicalDevice, m_Surface, &enumSize, m_SurfaceFormats.data());
+            vkGetPhysicalDeviceSurfacePresentModesKHR(m_PhysicalDevice, m_Surface, &enumSize, NULL);
+            m_PresentModes.resize(enumSize);
+            vkGetPhysicalDeviceSurfacePresentModesKHR(m_PhysicalDevice, m_Surface, &enumSize, m_PresentModes.data());
+
+            for (const auto& surfaceFormat : m_SurfaceFormats)
+            {
+                if (surfaceFormat.format == VK_FORMAT_B8G8R8A8_SRGB && surfaceFormat.colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR)
+                {
+                    m_SurfaceFormat = surfaceFormat;
+                    break;
+                }
+            }
+
+            for (const auto& presentMode : m_PresentModes)
+            {
+                if (presentMode == VK_PRESENT_MODE_MAILBOX_KHR)
+                {
+                    m_PresentMode = VK_PRESENT_MODE_MAILBOX_KHR;
+                    break;
+                }
+            }
+        }
+
+        inline VkSurfaceKHR GetSurface() const noexcept { return m_Surface; }
+        inline bool CanPresentFrom(std::uint32_t familyIndex) const noexcept { return m_PresentFamilies[familyIndex]; }
+        inline const VkSurfaceCapabilitiesKHR& GetSurfaceCapabilities() const noexcept { return m_SurfaceCapabilities; }
+        inline const VkSurfaceFormatKHR& GetSurfaceFormat() const noexcept { return m_SurfaceFormat.value(); }
+        inline const VkPresentModeKHR& GetPresentMode() const noexcept { return m_PresentMode.value(); }
+
+        inline bool IsSuitable() const noexcept { return m_SurfaceFormat.has_value() && m_PresentMode.has_value(); }
+    };
+}
+
+#endif
\ No newline at end of file
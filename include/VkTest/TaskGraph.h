@@ -0,0 +1,75 @@
+#ifndef VKTEST_TASK_GRAPH_H_
+#define VKTEST_TASK_GRAPH_H_
+
+#include <cstdint>
+#include <vector>
+#include <deque>
+#include <string>
+#include <functional>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <ostream>
+
+#include "VkTest/ThreadPool.h"
+
+namespace VkTest
+{
+    // runs a set of tasks as soon as their dependencies are done. tasks only depend on tasks
+    // added before them, so the graph can't have cycles and ids are already in topological order
+    class TaskGraph
+    {
+    public:
+        using TaskId = std::size_t;
+
+        enum class Affinity
+        {
+            Any,
+            MainThread // run on the thread that called Run, for APIs like glfw's window functions
+        };
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Task
+        {
+            std::string name;
+            std::function<void()> work;
+            std::vector<TaskId> dependencies;
+            std::vector<TaskId> dependents;
+            Affinity affinity;
+            std::size_t remaining;
+            Clock::time_point start;
+            Clock::time_point end;
+        };
+
+        std::vector<Task> m_Tasks;
+        Clock::time_point m_Start;
+        Clock::time_point m_End;
+
+        std::mutex m_Mutex;
+        std::condition_variable m_Condition;
+        std::deque<TaskId> m_MainThreadTasks;
+        std::size_t m_InFlight;
+        std::exception_ptr m_Error;
+
+        void Dispatch(ThreadPool& pool, TaskId id);
+        void Execute(ThreadPool& pool, TaskId id);
+        double GetDuration(TaskId id) const noexcept;
+    public:
+        TaskGraph() noexcept;
+
+        TaskGraph(const TaskGraph&) = delete;
+        TaskGraph& operator=(const TaskGraph&) = delete;
+
+        TaskId Add(std::string name, std::function<void()> work, std::vector<TaskId> dependencies = {}, Affinity affinity = Affinity::Any);
+        // blocks until every task has run, or rethrows the first failure once the tasks already started have finished
+        void Run(ThreadPool& pool);
+
+        // the chain of tasks that decided the total time, from first to last
+        std::vector<TaskId> GetCriticalPath() const;
+        void PrintReport(std::ostream& stream) const;
+    };
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,39 @@
+#ifndef VKTEST_THREAD_POOL_H_
+#define VKTEST_THREAD_POOL_H_
+
+#include <cstdint>
+#include <vector>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace VkTest
+{
+    class ThreadPool
+    {
+    private:
+        std::vector<std::thread> m_Threads;
+        std::mutex m_Mutex;
+        std::condition_variable m_Condition;
+        std::deque<std::function<void()>> m_Tasks;
+        bool m_Stopping;
+
+        void Work();
+    public:
+        ThreadPool(std::size_t threadCount);
+        ~ThreadPool() noexcept;
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        void Enqueue(std::function<void()> task);
+        // runs task(0) .. task(count - 1) on the pool and the calling thread, returns once they've all finished
+        void ParallelFor(std::size_t count, const std::function<void(std::size_t)>& task);
+
+        inline std::size_t GetThreadCount() const noexcept { return m_Threads.size(); }
+    };
+}
+
+#endif
\ No newline at end of file
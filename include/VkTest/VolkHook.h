@@ -0,0 +1,45 @@
+#ifndef VKTEST_VOLK_HOOK_H_
+#define VKTEST_VOLK_HOOK_H_
+
+#include <type_traits>
+
+#include "VkTest/IncludeVolk.h"
+
+namespace VkTest
+{
+    // volk keeps every entry point in a global function pointer, so a wrapper goes in by swapping
+    // the pointer and forwards to whatever was in the slot before, which may be another wrapper.
+    // Owner keeps the saved pointers of different hook sets apart, so they can be stacked as long
+    // as they're uninstalled in reverse order
+    template<typename Owner, auto* Slot>
+    class VolkHook
+    {
+    public:
+        using Function = std::remove_pointer_t<decltype(Slot)>;
+    private:
+        static inline Function original = nullptr;
+    public:
+        static void Install(Function hook) noexcept
+        {
+            original = *Slot;
+            *Slot = hook;
+        }
+
+        static void Uninstall() noexcept
+        {
+            if (original != nullptr)
+            {
+                *Slot = original;
+                original = nullptr;
+            }
+        }
+
+        template<typename... Args>
+        static auto CallOriginal(Args... args)
+        {
+            return original(args...);
+        }
+    };
+}
+
+#endif
\ No newline at end of file
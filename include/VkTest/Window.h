@@ -0,0 +1,29 @@
+#ifndef VKTEST_WINDOW_H_
+#define VKTEST_WINDOW_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "VkTest/IncludeVolk.h"
+
+#include <GLFW/glfw3.h>
+
+namespace VkTest
+{
+    // one output of the app: a window, its surface and its swapchain. everything else
+    // (device, pipelines, render target) is shared between windows
+    struct Window
+    {
+        GLFWwindow* handle = NULL;
+        VkSurfaceKHR surface = VK_NULL_HANDLE;
+        VkSwapchainKHR swapChain = VK_NULL_HANDLE;
+        VkExtent2D extent{};
+        std::vector<VkImage> images;
+        std::vector<VkImageView> imageViews;
+        std::vector<VkFramebuffer> framebuffers;
+        VkSemaphore imageAvailable = VK_NULL_HANDLE;
+        std::uint32_t imageIndex = 0;
+    };
+}
+
+#endif
\ No newline at end of file
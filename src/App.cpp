@@ -22,7 +22,7 @@ namespace VkTest
     {
         GPU* gpu = nullptr;
 
-        if (m_GPUs.size() == 1 && m_GPUs[0].HasGraphicsQueue())
+        if (m_GPUs.size() == 1 && m_GPUs[0].HasGraphicsQueue() && m_GPUs[0].HasTimelineSemaphore() && m_GPUs[0].HasSynchronization2())
         {
             gpu = &m_GPUs[0];
         }
@@ -68,54 +68,116 @@ namespace VkTest
 
         m_GPU = gpu;
         std::cout << "\nSelected GPU: " << (m_GPU->GetDeviceName()) << '\n';
-        std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
-        std::set<std::uint32_t> queueFamilyIndexes = {m_GPU->GetGraphicsQueueIndex(), m_GPU->GetPresentQueueIndex()};
-        float queuePriority = 1.0f;
+        std::uint32_t graphicsFamily = m_GPU->GetGraphicsQueueIndex();
+        std::uint32_t computeFamily = m_GPU->GetComputeQueueIndex();
+        std::uint32_t computeQueueIndex = 0;
 
-        for (std::uint32_t queueFamilyIndex : queueFamilyIndexes)
+        // runs on a pool thread during startup, the temporary lists come out of that thread's arena
+        Arena& arena = Arena::GetThreadArena();
+        ArenaScope arenaScope(arena);
+
+        // one priority per queue created in each family, graphics always takes queue 0 of its family
+        std::pmr::map<std::uint32_t, std::pmr::vector<float>> queuePriorities(&arena);
+        queuePriorities[graphicsFamily].push_back(m_Settings.graphicsQueuePriority);
+
+        if (computeFamily != graphicsFamily)
+        {
+            queuePriorities[computeFamily].push_back(m_Settings.computeQueuePriority);
+        }
+        else if (m_GPU->GetQueueCount(graphicsFamily) > 1)
+        {
+            // no dedicated family, a second queue in the graphics family still lets the two overlap
+            computeQueueIndex = 1;
+            queuePriorities[graphicsFamily].push_back(m_Settings.computeQueuePriority);
+        }
+
+        if (queuePriorities.find(m_GPU->GetPresentQueueIndex()) == queuePriorities.end())
+        {
+            queuePriorities[m_GPU->GetPresentQueueIndex()].push_back(m_Settings.graphicsQueuePriority);
+        }
+
+        std::pmr::vector<VkDeviceQueueCreateInfo> queueCreateInfos(&arena);
+
+        for (const auto& [queueFamilyIndex, priorities] : queuePriorities)
         {
             VkDeviceQueueCreateInfo queueCreateInfo{};
             queueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
             queueCreateInfo.queueFamilyIndex = queueFamilyIndex;
-            queueCreateInfo.queueCount = 1;
-            queueCreateInfo.pQueuePriorities = &queuePriority;
+            queueCreateInfo.queueCount = static_cast<std::uint32_t>(priorities.size());
+            queueCreateInfo.pQueuePriorities = priorities.data();
             queueCreateInfos.push_back(std::move(queueCreateInfo));
         }
 
         VkPhysicalDeviceFeatures deviceFeatures{};
+        VkPhysicalDeviceVulkan12Features vulkan12Features{};
+        vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+        vulkan12Features.timelineSemaphore = VK_TRUE;
+        VkPhysicalDeviceVulkan13Features vulkan13Features{};
+        vulkan13Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+        vulkan13Features.synchronization2 = VK_TRUE;
+        vulkan12Features.pNext = &vulkan13Features;
 
         VkDeviceCreateInfo createInfo{};
         createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+        createInfo.pNext = &vulkan12Features;
         createInfo.pQueueCreateInfos = queueCreateInfos.data();
         createInfo.queueCreateInfoCount = static_cast<std::uint32_t>(queueCreateInfos.size());
         createInfo.pEnabledFeatures = &deviceFeatures;
-        createInfo.enabledExtensionCount = static_cast<std::uint32_t>(m_DeviceExtensions.size());
-        createInfo.ppEnabledExtensionNames = m_DeviceExtensions.data();
+        std::pmr::vector<const char*> extensions(m_DeviceExtensions.begin(), m_DeviceExtensions.end(), &arena);
+        bool hasMemoryBudget = m_Settings.collectResourceStats && m_GPU->HasExtension(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+
+        if (hasMemoryBudget)
+        {
+            extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+        }
+
+        createInfo.enabledExtensionCount = static_cast<std::uint32_t>(extensions.size());
+        createInfo.ppEnabledExtensionNames = extensions.data();
 
         if (vkCreateDevice(m_GPU->GetPhysicalDevice(), &createInfo, NULL, &m_VkDevice) != VK_SUCCESS)
         {
             throw std::runtime_error("failed to create logical device");
         }
 
+        if (m_Settings.collectResourceStats)
+        {
+            // installed before anything else is created on the device so the counts start at zero
+            m_ResourceStats = std::make_unique<ResourceStats>(m_GPU->GetPhysicalDevice(), hasMemoryBudget);
+            m_ResourceStats->Install();
+        }
+
+        if (!m_Settings.capturePath.empty())
+        {
+            // chains onto the stats hooks, so it has to come off before them
+            m_Capture = std::make_unique<CommandCapture>(m_GPU->GetPhysicalDevice(), m_Settings.capturePath, m_Settings.captureFrames);
+            m_Capture->Install();
+        }
+
         vkGetDeviceQueue(m_VkDevice, m_GPU->GetGraphicsQueueIndex(), 0, &m_GraphicsQueue);
         vkGetDeviceQueue(m_VkDevice, m_GPU->GetPresentQueueIndex(), 0, &m_PresentQueue);
+
+        VkQueue computeQueue;
+        vkGetDeviceQueue(m_VkDevice, computeFamily, computeQueueIndex, &computeQueue);
+        m_Scheduler = std::make_unique<SubmitScheduler>(m_VkDevice);
+        m_GraphicsQueueId = m_Scheduler->AddQueue(m_GraphicsQueue);
+        m_ComputeQueue = std::make_unique<ComputeQueue>(m_VkDevice, *m_Scheduler, m_Scheduler->AddQueue(computeQueue), computeFamily);
+        std::cout << "Compute queue: family " << computeFamily << ", index " << computeQueueIndex << (computeQueue == m_GraphicsQueue ? " (shared with graphics)\n" : "\n");
     }
     
-    void App::CreateSwapChain()
+    void App::CreateSwapChain(Window& window, const SurfaceSupport& surfaceSupport)
     {
-        const auto& surfaceCapabilities = m_GPU->GetSurfaceCapabilities();
+        const auto& surfaceCapabilities = surfaceSupport.GetSurfaceCapabilities();
 
         if (surfaceCapabilities.currentExtent.width != 0xFFFFFFFF)
         {
-            m_SwapChainExtent.width = surfaceCapabilities.currentExtent.width;
-            m_SwapChainExtent.height = surfaceCapabilities.currentExtent.height;
+            window.extent.width = surfaceCapabilities.currentExtent.width;
+            window.extent.height = surfaceCapabilities.currentExtent.height;
         }
         else
         {
-            int w, h;
-            glfwGetFramebufferSize(m_Window, &w, &h);
-            m_SwapChainExtent.width = std::clamp(static_cast<std::uint32_t>(w), surfaceCapabilities.minImageExtent.width, surfaceCapabilities.maxImageExtent.width);
-            m_SwapChainExtent.height = std::clamp(static_cast<std::uint32_t>(h), surfaceCapabilities.minImageExtent.height, surfaceCapabilities.maxImageExtent.height);
+            // holds the framebuffer size from when the window was created
+            window.extent.width = std::clamp(window.extent.width, surfaceCapabilities.minImageExtent.width, surfaceCapabilities.maxImageExtent.width);
+            window.extent.height = std::clamp(window.extent.height, surfaceCapabilities.minImageExtent.height, surfaceCapabilities.maxImageExtent.height);
         }
 
         std::uint32_t imageCount = surfaceCapabilities.minImageCount + 1;
@@ -125,17 +187,31 @@ namespace VkTest
             imageCount = surfaceCapabilities.maxImageCount;
         }
 
-        const auto& surfaceFormat = m_GPU->GetSurfaceFormat();
+        const auto& surfaceFormat = surfaceSupport.GetSurfaceFormat();
 
         VkSwapchainCreateInfoKHR createInfo{};
         createInfo.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
-        createInfo.surface = m_Surface;
+        createInfo.surface = window.surface;
         createInfo.minImageCount = imageCount;
         createInfo.imageFormat = surfaceFormat.format;
         createInfo.imageColorSpace = surfaceFormat.colorSpace;
-        createInfo.imageExtent = m_SwapChainExtent;
+        createInfo.imageExtent = window.extent;
         createInfo.imageArrayLayers = 1;
         createInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+
+        if (m_Settings.dynamicResolution)
+        {
+            // the scene is blitted into the swapchain image rather than rendered to it
+            // transfer usage allows the copy, the format has to allow a blit on top of that
+            if ((surfaceCapabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_DST_BIT) == 0 ||
+                (m_GPU->GetOptimalTilingFeatures(surfaceFormat.format) & VK_FORMAT_FEATURE_BLIT_DST_BIT) == 0)
+            {
+                throw std::runtime_error("swapchain images can't be blitted to");
+            }
+
+            createInfo.imageUsage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+        }
+
         std::uint32_t queueFamilyIndices[] = {m_GPU->GetGraphicsQueueIndex(), m_GPU->GetPresentQueueIndex()};
         
         if (m_GPU->GetGraphicsQueueIndex() != m_GPU->GetPresentQueueIndex())
@@ -153,32 +229,32 @@ namespace VkTest
 
         createInfo.preTransform = surfaceCapabilities.currentTransform;
         createInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
-        createInfo.presentMode = m_GPU->GetPresentMode();
+        createInfo.presentMode = surfaceSupport.GetPresentMode();
         createInfo.clipped = VK_TRUE;
         createInfo.oldSwapchain = VK_NULL_HANDLE;
 
-        if (vkCreateSwapchainKHR(m_VkDevice, &createInfo, NULL, &m_SwapChain) != VK_SUCCESS)
+        if (vkCreateSwapchainKHR(m_VkDevice, &createInfo, NULL, &window.swapChain) != VK_SUCCESS)
         {
             throw std::runtime_error("couldn't create swapchain");
         }
 
         std::uint32_t enumSize;
-        vkGetSwapchainImagesKHR(m_VkDevice, m_SwapChain, &enumSize, NULL);
-        m_SwapChainImages.resize(enumSize);
-        vkGetSwapchainImagesKHR(m_VkDevice, m_SwapChain, &enumSize, m_SwapChainImages.data());
+        vkGetSwapchainImagesKHR(m_VkDevice, window.swapChain, &enumSize, NULL);
+        window.images.resize(enumSize);
+        vkGetSwapchainImagesKHR(m_VkDevice, window.swapChain, &enumSize, window.images.data());
     }
 
-    void App::CreateImageViews()
+    void App::CreateImageViews(Window& window)
     {
-        m_SwapChainImageViews.resize(m_SwapChainImages.size());
+        window.imageViews.resize(window.images.size());
 
-        for (std::uint32_t i = 0; i < m_SwapChainImages.size(); ++i)
+        for (std::uint32_t i = 0; i < window.images.size(); ++i)
         {
             VkImageViewCreateInfo createInfo{};
             createInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-            createInfo.image = m_SwapChainImages[i];
+            createInfo.image = window.images[i];
             createInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
-            createInfo.format = m_GPU->GetSurfaceFormat().format;
+            createInfo.format = m_GPU->GetSurface(0).GetSurfaceFormat().format;
             createInfo.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
             createInfo.components.g = VK_COMPONENT_SWIZZLE_IDENTITY;
             createInfo.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
@@ -189,37 +265,40 @@ namespace VkTest
             createInfo.subresourceRange.baseArrayLayer = 0;
             createInfo.subresourceRange.layerCount = 1;
 
-            if (vkCreateImageView(m_VkDevice, &createInfo, NULL, &m_SwapChainImageViews[i]) != VK_SUCCESS)
+            if (vkCreateImageView(m_VkDevice, &createInfo, NULL, &window.imageViews[i]) != VK_SUCCESS)
             {
                 throw std::runtime_error("failed to create image views");
             }
         }
     }
 
-    App::App() : m_Window(NULL), m_VkInst(VK_NULL_HANDLE), m_Surface(VK_NULL_HANDLE), m_VkDevice(VK_NULL_HANDLE), m_SwapChain(VK_NULL_HANDLE), m_RenderPass(VK_NULL_HANDLE), m_PipelineLayout(VK_NULL_HANDLE), m_Pipeline(VK_NULL_HANDLE),
-    m_CommandPool(VK_NULL_HANDLE), m_CommandBuffer(VK_NULL_HANDLE)
+    void App::CreateWindows()
     {
-        if (glfwInit() == GLFW_FALSE)
-        {
-            throw std::runtime_error("glfw failed to initialise");
-        }
-
         glfwDefaultWindowHints();
         glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
         glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
         glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
-        m_Window = glfwCreateWindow(1280, 720, "Vulkan Test", NULL, NULL);
 
-        if (m_Window == NULL)
+        for (std::uint32_t i = 0; i < m_Windows.size(); ++i)
         {
-            throw std::runtime_error("couldn't create window");
-        }
+            std::string title = i == 0 ? "Vulkan Test" : "Vulkan Test (" + std::to_string(i + 1) + ")";
+            m_Windows[i].handle = glfwCreateWindow(1280, 720, title.c_str(), NULL, NULL);
 
-        if (volkInitialize() != VK_SUCCESS)
-        {
-            throw std::runtime_error("failed to initialise volk");
+            if (m_Windows[i].handle == NULL)
+            {
+                throw std::runtime_error("couldn't create window");
+            }
+
+            // windows can't be resized, so the size is read once here on the main thread where glfw allows it
+            int w, h;
+            glfwGetFramebufferSize(m_Windows[i].handle, &w, &h);
+            m_Windows[i].extent.width = static_cast<std::uint32_t>(w);
+            m_Windows[i].extent.height = static_cast<std::uint32_t>(h);
         }
+    }
 
+    void App::CreateInstance()
+    {
         VkApplicationInfo appInfo{};
         appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
         appInfo.pApplicationName = "Vulkan Test";
@@ -281,10 +360,26 @@ namespace VkTest
             throw std::runtime_error("failed to set up debug messenger");
         }
     #endif
+    }
 
-        if (glfwCreateWindowSurface(m_VkInst, m_Window, NULL, &m_Surface) != VK_SUCCESS)
+    void App::CreateSurfaces()
+    {
+        for (auto& window : m_Windows)
         {
-            throw std::runtime_error("couldn't create window surface");
+            if (glfwCreateWindowSurface(m_VkInst, window.handle, NULL, &window.surface) != VK_SUCCESS)
+            {
+                throw std::runtime_error("couldn't create window surface");
+            }
+        }
+    }
+
+    void App::FindGPUs()
+    {
+        std::vector<VkSurfaceKHR> surfaces;
+
+        for (const auto& window : m_Windows)
+        {
+            surfaces.push_back(window.surface);
         }
 
         std::uint32_t enumSize;
@@ -297,27 +392,238 @@ namespace VkTest
 
         for (const auto& device : physicalDevices)
         {
-            const GPU& gpu = m_GPUs.emplace_back(device, m_Surface);
+            const GPU& gpu = m_GPUs.emplace_back(device, surfaces);
             std::cout << "Found GPU: " << gpu << '\n';
         }
+    }
+
+    App::App(const AppSettings& settings) : m_Settings(settings), m_VkInst(VK_NULL_HANDLE), m_VkDevice(VK_NULL_HANDLE), m_RenderPass(VK_NULL_HANDLE), m_PipelineLayout(VK_NULL_HANDLE), m_Pipeline(VK_NULL_HANDLE), m_TransparentPipeline(VK_NULL_HANDLE), m_DepthPipeline(VK_NULL_HANDLE),
+    m_DepthImage(VK_NULL_HANDLE), m_DepthMemory(VK_NULL_HANDLE), m_DepthView(VK_NULL_HANDLE), m_DrawList(m_FarPlane), m_PendingPipeline(VK_NULL_HANDLE), m_PendingTransparentPipeline(VK_NULL_HANDLE), m_PendingDepthPipeline(VK_NULL_HANDLE), m_ResolutionScaler(settings.targetFrameTime, settings.minRenderScale, settings.maxRenderScale), m_RenderTarget(VK_NULL_HANDLE), m_RenderTargetMemory(VK_NULL_HANDLE), m_RenderTargetView(VK_NULL_HANDLE), m_RenderTargetFramebuffer(VK_NULL_HANDLE),
+    m_RenderTargetExtent{}, m_BlitFilter(VK_FILTER_NEAREST), m_CommandPool(VK_NULL_HANDLE), m_CommandBuffer(VK_NULL_HANDLE), m_RenderFinishedSemaphore(VK_NULL_HANDLE), m_LastFrameValue(0), m_FrameCount(0), m_LastFrameHeapAllocations(0)
+    {
+        if (m_Settings.windowCount == 0) { throw std::runtime_error("at least one window is needed"); }
+
+        // the main thread runs the glfw tasks, so it gets left a core of its own
+        m_ThreadPool = std::make_unique<ThreadPool>(std::max(2u, std::thread::hardware_concurrency()) - 1);
+        m_Windows.resize(m_Settings.windowCount);
+
+        // every step only waits for what it uses, so shader loading overlaps instance creation
+        // and the pipeline gets compiled while the swapchains are being made
+        TaskGraph startup;
+        std::vector<char> vertShaderCode;
+        std::vector<char> fragShaderCode;
+
+        auto glfw = startup.Add("glfw", []()
+        {
+            if (glfwInit() == GLFW_FALSE)
+            {
+                throw std::runtime_error("glfw failed to initialise");
+            }
+        }, {}, TaskGraph::Affinity::MainThread);
+
+        auto windows = startup.Add("windows", [this]() { CreateWindows(); }, {glfw}, TaskGraph::Affinity::MainThread);
+
+        auto volk = startup.Add("volk", []()
+        {
+            if (volkInitialize() != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to initialise volk");
+            }
+        });
+
+        auto instance = startup.Add("instance", [this]() { CreateInstance(); }, {glfw, volk});
+        auto shaders = startup.Add("shader loading", [&]() { LoadShaderCode(vertShaderCode, fragShaderCode); });
+        auto surfaces = startup.Add("surfaces", [this]() { CreateSurfaces(); }, {windows, instance});
+        auto gpus = startup.Add("gpu probing", [this]() { FindGPUs(); }, {surfaces});
+
+        auto device = startup.Add("logical device", [this]()
+        {
+            CreateLogicalDevice();
+
+            // one render pass and pipeline serve every window, so their formats have to agree
+            for (std::size_t i = 0; i < m_Windows.size(); ++i)
+            {
+                if (m_GPU->GetSurface(i).GetSurfaceFormat().format != m_GPU->GetSurface(0).GetSurfaceFormat().format)
+                {
+                    throw std::runtime_error("windows ended up with different surface formats");
+                }
+            }
+        }, {gpus});
+
+        std::vector<TaskGraph::TaskId> swapChains;
+
+        for (std::size_t i = 0; i < m_Windows.size(); ++i)
+        {
+            swapChains.push_back(startup.Add("swapchain " + std::to_string(i), [this, i]()
+            {
+                CreateSwapChain(m_Windows[i], m_GPU->GetSurface(i));
+                CreateImageViews(m_Windows[i]);
+            }, {device}));
+        }
+
+        auto renderPass = startup.Add("render pass", [this]() { CreateRenderPass(); }, {device});
+        auto pipeline = startup.Add("graphics pipeline", [&]() { CreateGraphicsPipeline(vertShaderCode, fragShaderCode); }, {renderPass, shaders});
+        std::vector<TaskGraph::TaskId> framebufferDependencies = swapChains;
+        framebufferDependencies.push_back(renderPass);
+        framebufferDependencies.push_back(startup.Add("depth buffer", [this]() { CreateDepthBuffer(); }, swapChains));
+
+        if (m_Settings.dynamicResolution)
+        {
+            framebufferDependencies.push_back(startup.Add("render target", [this]() { CreateRenderTarget(); }, swapChains));
+        }
+
+        startup.Add("framebuffers", [this]() { CreateFramebuffers(); }, framebufferDependencies);
+
+        startup.Add("command buffer", [this]()
+        {
+            CreateCommandPool();
+            CreateCommandBuffer();
+        }, {device});
+
+        startup.Add("sync objects", [this]() { CreateSyncObjects(); }, {device});
+
+        if (m_Settings.hotReloadShaders)
+        {
+            startup.Add("shader watcher", [this]() { StartShaderWatcher(); }, {pipeline});
+        }
 
-        CreateLogicalDevice();
-        std::cout << "Logical device created.\n";
-        CreateSwapChain();
-        std::cout << "Swap chain created.\n";
-        //glfwShowWindow(m_Window);
+        startup.Run(*m_ThreadPool);
+
+        // what got created and when is in the report below, these only describe the configuration
+        std::cout << "Rendering to " << m_Windows.size() << " window(s).\n";
+
+        if (m_Settings.dynamicResolution)
+        {
+            std::cout << "Dynamic resolution enabled, target frame time: " << m_Settings.targetFrameTime << "ms\n";
+        }
+
+        if (m_Settings.depthPrepass)
+        {
+            std::cout << "Depth prepass enabled.\n";
+        }
+
+        if (m_Settings.hotReloadShaders)
+        {
+            std::cout << "Watching shaders for changes.\n";
+        }
+
+        if (m_Capture)
+        {
+            std::cout << "Capturing command stream to " << m_Settings.capturePath << ".\n";
+        }
+
+        std::cout << '\n';
+        startup.PrintReport(std::cout);
+    }
+
+    void App::Run()
+    {
+        for (const auto& window : m_Windows)
+        {
+            glfwShowWindow(window.handle);
+        }
+
+        // closing any of the windows ends the run
+        auto shouldClose = [this]()
+        {
+            return std::any_of(m_Windows.begin(), m_Windows.end(), [](const Window& window) { return glfwWindowShouldClose(window.handle); });
+        };
+
+        while (!shouldClose())
+        {
+            // counted around the whole iteration so the stats bookkeeping is included, which means
+            // the stats can only ever report the iteration before the one they're recorded in
+            std::uint64_t heapAllocations = GetGlobalAllocationCount();
+            glfwPollEvents();
+            DrawFrame();
+            m_LastFrameHeapAllocations = GetGlobalAllocationCount() - heapAllocations;
+        }
+
+        vkDeviceWaitIdle(m_VkDevice);
     }
 
     App::~App() noexcept
     {
+        // stop the watcher first so nothing can build a pipeline during teardown
+        m_ShaderWatcher.reset();
+
+        if (m_VkDevice != VK_NULL_HANDLE)
+        {
+            vkDeviceWaitIdle(m_VkDevice);
+        }
+
+        // retired objects go first, in the order they were handed over
+        m_DeletionQueue.Flush();
+
+        if (m_RenderFinishedSemaphore != VK_NULL_HANDLE)
+        {
+            vkDestroySemaphore(m_VkDevice, m_RenderFinishedSemaphore, NULL);
+        }
+
+
         if (m_CommandPool != VK_NULL_HANDLE)
         {
             vkDestroyCommandPool(m_VkDevice, m_CommandPool, NULL);
         }
 
-        for (auto framebuffer : m_Framebuffers)
+        if (m_DepthView != VK_NULL_HANDLE)
         {
-            vkDestroyFramebuffer(m_VkDevice, framebuffer, NULL);
+            vkDestroyImageView(m_VkDevice, m_DepthView, NULL);
+        }
+
+        if (m_DepthImage != VK_NULL_HANDLE)
+        {
+            vkDestroyImage(m_VkDevice, m_DepthImage, NULL);
+        }
+
+        if (m_DepthMemory != VK_NULL_HANDLE)
+        {
+            vkFreeMemory(m_VkDevice, m_DepthMemory, NULL);
+        }
+
+        if (m_RenderTargetFramebuffer != VK_NULL_HANDLE)
+        {
+            vkDestroyFramebuffer(m_VkDevice, m_RenderTargetFramebuffer, NULL);
+        }
+
+        if (m_RenderTargetView != VK_NULL_HANDLE)
+        {
+            vkDestroyImageView(m_VkDevice, m_RenderTargetView, NULL);
+        }
+
+        if (m_RenderTarget != VK_NULL_HANDLE)
+        {
+            vkDestroyImage(m_VkDevice, m_RenderTarget, NULL);
+        }
+
+        if (m_RenderTargetMemory != VK_NULL_HANDLE)
+        {
+            vkFreeMemory(m_VkDevice, m_RenderTargetMemory, NULL);
+        }
+
+        if (m_PendingPipeline != VK_NULL_HANDLE)
+        {
+            vkDestroyPipeline(m_VkDevice, m_PendingPipeline, NULL);
+        }
+
+        if (m_PendingTransparentPipeline != VK_NULL_HANDLE)
+        {
+            vkDestroyPipeline(m_VkDevice, m_PendingTransparentPipeline, NULL);
+        }
+
+        if (m_PendingDepthPipeline != VK_NULL_HANDLE)
+        {
+            vkDestroyPipeline(m_VkDevice, m_PendingDepthPipeline, NULL);
+        }
+
+        if (m_DepthPipeline != VK_NULL_HANDLE)
+        {
+            vkDestroyPipeline(m_VkDevice, m_DepthPipeline, NULL);
+        }
+
+        if (m_TransparentPipeline != VK_NULL_HANDLE)
+        {
+            vkDestroyPipeline(m_VkDevice, m_TransparentPipeline, NULL);
         }
 
         if (m_Pipeline != VK_NULL_HANDLE)
@@ -335,24 +641,58 @@ namespace VkTest
             vkDestroyRenderPass(m_VkDevice, m_RenderPass, NULL);
         }
 
-        for (const auto& imageView : m_SwapChainImageViews)
+        for (const auto& window : m_Windows)
         {
-            vkDestroyImageView(m_VkDevice, imageView, NULL);
+            for (auto framebuffer : window.framebuffers)
+            {
+                vkDestroyFramebuffer(m_VkDevice, framebuffer, NULL);
+            }
+
+            for (const auto& imageView : window.imageViews)
+            {
+                vkDestroyImageView(m_VkDevice, imageView, NULL);
+            }
+
+            if (window.swapChain != VK_NULL_HANDLE)
+            {
+                vkDestroySwapchainKHR(m_VkDevice, window.swapChain, NULL);
+            }
+
+            if (window.imageAvailable != VK_NULL_HANDLE)
+            {
+                vkDestroySemaphore(m_VkDevice, window.imageAvailable, NULL);
+            }
         }
+        
+        m_ComputeQueue.reset();
+        m_Scheduler.reset();
+        m_Capture.reset();
 
-        if (m_SwapChain != VK_NULL_HANDLE)
+        if (m_ResourceStats)
         {
-            vkDestroySwapchainKHR(m_VkDevice, m_SwapChain, NULL);
+            // everything created on the device should be gone by now
+            for (const auto& [type, counter] : m_ResourceStats->GetSnapshot().objects)
+            {
+                if (counter.current > 0)
+                {
+                    std::cerr << "Leaked " << counter.current << " object(s) of type " << ResourceStats::GetObjectTypeName(type) << '\n';
+                }
+            }
+
+            m_ResourceStats.reset();
         }
-        
+
         if (m_VkDevice != VK_NULL_HANDLE)
         {
             vkDestroyDevice(m_VkDevice, NULL);
         }
 
-        if (m_Surface != VK_NULL_HANDLE)
+        for (const auto& window : m_Windows)
         {
-            vkDestroySurfaceKHR(m_VkInst, m_Surface, NULL);
+            if (window.surface != VK_NULL_HANDLE)
+            {
+                vkDestroySurfaceKHR(m_VkInst, window.surface, NULL);
+            }
         }
 
     #ifdef VK_TEST_DEBUG
@@ -372,9 +712,12 @@ namespace VkTest
             vkDestroyInstance(m_VkInst, NULL);
         }
 
-        if (m_Window != NULL)
+        for (const auto& window : m_Windows)
         {
-            glfwDestroyWindow(m_Window);
+            if (window.handle != NULL)
+            {
+                glfwDestroyWindow(window.handle);
+            }
         }
 
         glfwTerminate();
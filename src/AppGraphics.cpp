@@ -1,12 +1,14 @@
 #include "VkTest/App.h"
 
+#include <array>
+
 namespace VkTest
 {
     std::vector<char> fileToCharArray(const std::string& path)
     {
         std::ifstream file(path, std::ios::ate | std::ios::binary);
 
-        if (file.is_open()) { throw std::runtime_error("couldn't open '" + path + "'"); }
+        if (!file.is_open()) { throw std::runtime_error("couldn't open '" + path + "'"); }
 
         std::size_t fileSize = static_cast<std::size_t>(file.tellg());
         std::vector<char> buffer(fileSize);
@@ -18,30 +20,102 @@ namespace VkTest
     void App::CreateRenderPass()
     {
         VkAttachmentDescription colorAttachment{};
-        colorAttachment.format = m_GPU->GetSurfaceFormat().format;
+        colorAttachment.format = m_GPU->GetSurface(0).GetSurfaceFormat().format;
         colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
         colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
         colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
         colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
         colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
         colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+        // with dynamic resolution the scene goes to the render target and gets blitted out of it
+        colorAttachment.finalLayout = m_Settings.dynamicResolution ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+
+        // depth is only needed while the pass runs, so it's never stored
+        VkAttachmentDescription depthAttachment{};
+        depthAttachment.format = ChooseDepthFormat();
+        depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+        depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+        VkAttachmentDescription attachments[] = {colorAttachment, depthAttachment};
 
         VkAttachmentReference colorAttachmentRef{};
         colorAttachmentRef.attachment = 0;
         colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
 
-        VkSubpassDescription subpass{};
-        subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
-        subpass.colorAttachmentCount = 1;
-        subpass.pColorAttachments = &colorAttachmentRef;
+        VkAttachmentReference depthAttachmentRef{};
+        depthAttachmentRef.attachment = 1;
+        depthAttachmentRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+        // with the prepass, subpass 0 only writes depth and subpass 1 shades against it
+        VkSubpassDescription subpasses[] = {{},{}};
+        std::uint32_t colorSubpass = m_Settings.depthPrepass ? 1 : 0;
+
+        subpasses[0].pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+        subpasses[0].pDepthStencilAttachment = &depthAttachmentRef;
+
+        subpasses[colorSubpass].pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+        subpasses[colorSubpass].colorAttachmentCount = 1;
+        subpasses[colorSubpass].pColorAttachments = &colorAttachmentRef;
+        subpasses[colorSubpass].pDepthStencilAttachment = &depthAttachmentRef;
+
+        std::vector<VkSubpassDependency> dependencies;
+
+        // the depth buffer is shared by every window, so each pass also waits for the last one's depth writes.
+        // depth is read and written in both fragment test stages, so both are on each side
+        VkSubpassDependency& externalDepth = dependencies.emplace_back();
+        externalDepth.srcSubpass = VK_SUBPASS_EXTERNAL;
+        externalDepth.dstSubpass = 0;
+        externalDepth.srcStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+        externalDepth.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        externalDepth.dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+        externalDepth.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+        // the colour clear waits for the acquire semaphore and, with dynamic resolution, the last blit out
+        // of the render target. that's the second subpass with the prepass, not the first
+        VkSubpassDependency& externalColor = dependencies.emplace_back();
+        externalColor.srcSubpass = VK_SUBPASS_EXTERNAL;
+        externalColor.dstSubpass = colorSubpass;
+        externalColor.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
+        externalColor.srcAccessMask = 0;
+        externalColor.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        externalColor.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+
+        if (m_Settings.depthPrepass)
+        {
+            VkSubpassDependency& prepass = dependencies.emplace_back();
+            prepass.srcSubpass = 0;
+            prepass.dstSubpass = 1;
+            prepass.srcStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+            prepass.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+            prepass.dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+            prepass.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+            prepass.dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+        }
+
+        if (m_Settings.dynamicResolution)
+        {
+            VkSubpassDependency& blit = dependencies.emplace_back();
+            blit.srcSubpass = colorSubpass;
+            blit.dstSubpass = VK_SUBPASS_EXTERNAL;
+            blit.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+            blit.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+            blit.dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+            blit.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        }
 
         VkRenderPassCreateInfo renderPassCreateInfo{};
         renderPassCreateInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-        renderPassCreateInfo.attachmentCount = 1;
-        renderPassCreateInfo.pAttachments = &colorAttachment;
-        renderPassCreateInfo.subpassCount = 1;
-        renderPassCreateInfo.pSubpasses = &subpass;
+        renderPassCreateInfo.attachmentCount = 2;
+        renderPassCreateInfo.pAttachments = attachments;
+        renderPassCreateInfo.subpassCount = colorSubpass + 1;
+        renderPassCreateInfo.pSubpasses = subpasses;
+        renderPassCreateInfo.dependencyCount = static_cast<std::uint32_t>(dependencies.size());
+        renderPassCreateInfo.pDependencies = dependencies.data();
 
         if (vkCreateRenderPass(m_VkDevice, &renderPassCreateInfo, NULL, &m_RenderPass) != VK_SUCCESS)
         {
@@ -49,11 +123,40 @@ namespace VkTest
         }
     }
 
-    void App::CreateGraphicsPipeline()
+    void App::LoadShaderCode(std::vector<char>& vertShaderCode, std::vector<char>& fragShaderCode)
     {
-        auto vertShaderCode = fileToCharArray("shaders/vertex.spv");
-        auto fragShaderCode = fileToCharArray("shaders/fragment.spv");
+        vertShaderCode = fileToCharArray("shaders/vertex.spv");
+        fragShaderCode = fileToCharArray("shaders/fragment.spv");
+    }
+
+    void App::CreateGraphicsPipeline(const std::vector<char>& vertShaderCode, const std::vector<char>& fragShaderCode)
+    {
+        VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo{};
+        pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutCreateInfo.setLayoutCount = 0;
+        pipelineLayoutCreateInfo.pSetLayouts = nullptr;
+        pipelineLayoutCreateInfo.pushConstantRangeCount = 0;
+        pipelineLayoutCreateInfo.pPushConstantRanges = nullptr;
 
+        if (vkCreatePipelineLayout(m_VkDevice, &pipelineLayoutCreateInfo, NULL, &m_PipelineLayout) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create pipeline layout");
+        }
+
+        m_Pipeline = BuildGraphicsPipeline(vertShaderCode, fragShaderCode, PipelineKind::Opaque);
+        m_TransparentPipeline = BuildGraphicsPipeline(vertShaderCode, fragShaderCode, PipelineKind::Transparent);
+
+        if (m_Settings.depthPrepass)
+        {
+            m_DepthPipeline = BuildGraphicsPipeline(vertShaderCode, fragShaderCode, PipelineKind::DepthPrepass);
+        }
+    }
+
+    VkPipeline App::BuildGraphicsPipeline(const std::vector<char>& vertShaderCode, const std::vector<char>& fragShaderCode, PipelineKind kind) const
+    {
+        // called from the shader watcher thread too, so this only reads state that's fixed after startup.
+        // the depth only variant is the prepass pipeline, it shares the vertex shader so both passes agree on depth
+        bool depthOnly = kind == PipelineKind::DepthPrepass;
         VkShaderModule vertShaderModule;
         VkShaderModuleCreateInfo vertShaderCreateInfo{};
         vertShaderCreateInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
@@ -104,24 +207,13 @@ namespace VkTest
         inputAssemblyCreateInfo.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
         inputAssemblyCreateInfo.primitiveRestartEnable = VK_FALSE;
 
-        VkViewport viewport{};
-        viewport.x = 0.0f;
-        viewport.y = 0.0f;
-        viewport.width = static_cast<float>(m_SwapChainExtent.width);
-        viewport.height = static_cast<float>(m_SwapChainExtent.height);
-        viewport.minDepth = 0.0f;
-        viewport.maxDepth = 1.0f;
-
-        VkRect2D scissor{};
-        scissor.offset = {0, 0};
-        scissor.extent = m_SwapChainExtent;
-
+        // viewport and scissor are dynamic, so the pipeline doesn't have to wait for a swapchain extent
         VkPipelineViewportStateCreateInfo viewportStateCreateInfo{};
         viewportStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
         viewportStateCreateInfo.viewportCount = 1;
-        viewportStateCreateInfo.pViewports = &viewport;
+        viewportStateCreateInfo.pViewports = nullptr;
         viewportStateCreateInfo.scissorCount = 1;
-        viewportStateCreateInfo.pScissors = &scissor;
+        viewportStateCreateInfo.pScissors = nullptr;
 
         VkPipelineRasterizationStateCreateInfo rasterizerCreateInfo{};
         rasterizerCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
@@ -158,73 +250,356 @@ namespace VkTest
         colorBlendingCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
         colorBlendingCreateInfo.logicOpEnable = VK_FALSE;
         colorBlendingCreateInfo.logicOp = VK_LOGIC_OP_COPY;
-        colorBlendingCreateInfo.attachmentCount = 1;
+        colorBlendingCreateInfo.attachmentCount = depthOnly ? 0 : 1;
         colorBlendingCreateInfo.pAttachments = &colorBlendAttachment;
         colorBlendingCreateInfo.blendConstants[0] = 0.0f;
         colorBlendingCreateInfo.blendConstants[1] = 0.0f;
         colorBlendingCreateInfo.blendConstants[2] = 0.0f;
         colorBlendingCreateInfo.blendConstants[3] = 0.0f;
 
-        VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo{};
-        pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-        pipelineLayoutCreateInfo.setLayoutCount = 0;
-        pipelineLayoutCreateInfo.pSetLayouts = nullptr;
-        pipelineLayoutCreateInfo.pushConstantRangeCount = 0;
-        pipelineLayoutCreateInfo.pPushConstantRanges = nullptr;
-
-        if (vkCreatePipelineLayout(m_VkDevice, &pipelineLayoutCreateInfo, NULL, &m_PipelineLayout) != VK_SUCCESS)
-        {
-            throw std::runtime_error("failed to create pipeline layout");
-        }
+        // after a prepass the colour pass only tests against the depth that's already there.
+        // transparents never write it, or they'd hide whatever is sorted behind them
+        bool writesDepth = depthOnly || (kind == PipelineKind::Opaque && !m_Settings.depthPrepass);
+        VkPipelineDepthStencilStateCreateInfo depthStencilCreateInfo{};
+        depthStencilCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+        depthStencilCreateInfo.depthTestEnable = VK_TRUE;
+        depthStencilCreateInfo.depthWriteEnable = writesDepth ? VK_TRUE : VK_FALSE;
+        depthStencilCreateInfo.depthCompareOp = (m_Settings.depthPrepass && !depthOnly) ? VK_COMPARE_OP_LESS_OR_EQUAL : VK_COMPARE_OP_LESS;
+        depthStencilCreateInfo.depthBoundsTestEnable = VK_FALSE;
+        depthStencilCreateInfo.stencilTestEnable = VK_FALSE;
+        depthStencilCreateInfo.minDepthBounds = 0.0f;
+        depthStencilCreateInfo.maxDepthBounds = 1.0f;
 
         VkGraphicsPipelineCreateInfo pipelineCreateInfo{};
         pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-        pipelineCreateInfo.stageCount = 2;
+        pipelineCreateInfo.stageCount = depthOnly ? 1 : 2;
         pipelineCreateInfo.pStages = shaderStageCreateInfos;
         pipelineCreateInfo.pVertexInputState = &vertexInputCreateInfo;
         pipelineCreateInfo.pInputAssemblyState = &inputAssemblyCreateInfo;
         pipelineCreateInfo.pViewportState = &viewportStateCreateInfo;
         pipelineCreateInfo.pRasterizationState = &rasterizerCreateInfo;
         pipelineCreateInfo.pMultisampleState = &multisamplingCreateInfo;
-        pipelineCreateInfo.pDepthStencilState = nullptr;
+        pipelineCreateInfo.pDepthStencilState = &depthStencilCreateInfo;
         pipelineCreateInfo.pColorBlendState = &colorBlendingCreateInfo;
         pipelineCreateInfo.pDynamicState = &dynamicStateCreateInfo;
         pipelineCreateInfo.layout = m_PipelineLayout;
         pipelineCreateInfo.renderPass = m_RenderPass;
-        pipelineCreateInfo.subpass = 0;
+        pipelineCreateInfo.subpass = (!depthOnly && m_Settings.depthPrepass) ? 1 : 0;
         pipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
         pipelineCreateInfo.basePipelineIndex = -1;
 
-        if (vkCreateGraphicsPipelines(m_VkDevice, VK_NULL_HANDLE, 1, &pipelineCreateInfo, NULL, &m_Pipeline) != VK_SUCCESS)
+        VkPipeline pipeline;
+        VkResult result = vkCreateGraphicsPipelines(m_VkDevice, VK_NULL_HANDLE, 1, &pipelineCreateInfo, NULL, &pipeline);
+
+        vkDestroyShaderModule(m_VkDevice, fragShaderModule, NULL);
+        vkDestroyShaderModule(m_VkDevice, vertShaderModule, NULL);
+
+        if (result != VK_SUCCESS)
         {
             throw std::runtime_error("failed to create graphics pipeline");
         }
 
-        vkDestroyShaderModule(m_VkDevice, fragShaderModule, NULL);
-        vkDestroyShaderModule(m_VkDevice, vertShaderModule, NULL);
+        return pipeline;
     }
 
-    void App::CreateFramebuffers()
+    void App::StartShaderWatcher()
     {
-        m_Framebuffers.resize(m_SwapChainImageViews.size());
+        m_ShaderWatcher = std::make_unique<ShaderWatcher>("shaders", m_Settings.shaderCompiler, [this](const std::vector<std::string>& rebuilt)
+        {
+            try
+            {
+                std::vector<char> vertShaderCode;
+                std::vector<char> fragShaderCode;
+                LoadShaderCode(vertShaderCode, fragShaderCode);
+                VkPipeline pipeline = BuildGraphicsPipeline(vertShaderCode, fragShaderCode, PipelineKind::Opaque);
+                VkPipeline transparentPipeline = VK_NULL_HANDLE;
+                VkPipeline depthPipeline = VK_NULL_HANDLE;
+
+                try
+                {
+                    transparentPipeline = BuildGraphicsPipeline(vertShaderCode, fragShaderCode, PipelineKind::Transparent);
+
+                    // the prepass has to be rebuilt with the same vertex shader or the depth equality breaks
+                    if (m_Settings.depthPrepass)
+                    {
+                        depthPipeline = BuildGraphicsPipeline(vertShaderCode, fragShaderCode, PipelineKind::DepthPrepass);
+                    }
+                }
+                catch (const std::runtime_error&)
+                {
+                    // the transparent pipeline is still null if that's the one that failed, which vkDestroyPipeline ignores
+                    vkDestroyPipeline(m_VkDevice, transparentPipeline, NULL);
+                    vkDestroyPipeline(m_VkDevice, pipeline, NULL);
+                    throw;
+                }
+
+                std::lock_guard<std::mutex> lock(m_PendingPipelineMutex);
+
+                // a pending pipeline that never got swapped in was never used by the GPU
+                if (m_PendingPipeline != VK_NULL_HANDLE)
+                {
+                    vkDestroyPipeline(m_VkDevice, m_PendingPipeline, NULL);
+                    vkDestroyPipeline(m_VkDevice, m_PendingTransparentPipeline, NULL);
+                    vkDestroyPipeline(m_VkDevice, m_PendingDepthPipeline, NULL);
+                }
+
+                m_PendingPipeline = pipeline;
+                m_PendingTransparentPipeline = transparentPipeline;
+                m_PendingDepthPipeline = depthPipeline;
+                std::cout << "Rebuilt graphics pipeline after " << rebuilt.size() << " shader change(s)\n";
+            }
+            catch (const std::runtime_error& e)
+            {
+                std::cerr << "Shader reload failed: " << e.what() << '\n';
+            }
+        });
+    }
+
+    void App::SwapPendingPipeline()
+    {
+        VkPipeline pipeline;
+        VkPipeline transparentPipeline;
+        VkPipeline depthPipeline;
+
+        {
+            std::lock_guard<std::mutex> lock(m_PendingPipelineMutex);
+            pipeline = m_PendingPipeline;
+            transparentPipeline = m_PendingTransparentPipeline;
+            depthPipeline = m_PendingDepthPipeline;
+            m_PendingPipeline = VK_NULL_HANDLE;
+            m_PendingTransparentPipeline = VK_NULL_HANDLE;
+            m_PendingDepthPipeline = VK_NULL_HANDLE;
+        }
+
+        if (pipeline == VK_NULL_HANDLE) { return; }
+
+        VkPipeline oldPipeline = m_Pipeline;
+        VkPipeline oldTransparentPipeline = m_TransparentPipeline;
+        VkPipeline oldDepthPipeline = m_DepthPipeline;
+        m_Pipeline = pipeline;
+        m_TransparentPipeline = transparentPipeline;
+        m_DepthPipeline = depthPipeline;
+
+        // the depth pipeline is null without a prepass, which vkDestroyPipeline ignores
+        DeferDestruction([device = m_VkDevice, oldPipeline, oldTransparentPipeline, oldDepthPipeline]()
+        {
+            vkDestroyPipeline(device, oldPipeline, NULL);
+            vkDestroyPipeline(device, oldTransparentPipeline, NULL);
+            vkDestroyPipeline(device, oldDepthPipeline, NULL);
+        });
+    }
+
+    void App::CreateRenderTarget()
+    {
+        VkFormat format = m_GPU->GetSurface(0).GetSurfaceFormat().format;
+        VkFormatFeatureFlags features = m_GPU->GetOptimalTilingFeatures(format);
+
+        if ((features & VK_FORMAT_FEATURE_COLOR_ATTACHMENT_BIT) == 0 || (features & VK_FORMAT_FEATURE_BLIT_SRC_BIT) == 0)
+        {
+            throw std::runtime_error("surface format can't be used as a scaled render target");
+        }
+
+        // a linear blit needs linear filtering on the source format, otherwise it falls back to nearest
+        m_BlitFilter = (features & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT) ? VK_FILTER_LINEAR : VK_FILTER_NEAREST;
+
+        // allocated once at the size of the largest window, the scaled resolution only ever uses the top left corner of it
+        for (const auto& window : m_Windows)
+        {
+            m_RenderTargetExtent.width = std::max(m_RenderTargetExtent.width, window.extent.width);
+            m_RenderTargetExtent.height = std::max(m_RenderTargetExtent.height, window.extent.height);
+        }
+
+        VkImageCreateInfo imageCreateInfo{};
+        imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageCreateInfo.format = format;
+        imageCreateInfo.extent.width = m_RenderTargetExtent.width;
+        imageCreateInfo.extent.height = m_RenderTargetExtent.height;
+        imageCreateInfo.extent.depth = 1;
+        imageCreateInfo.mipLevels = 1;
+        imageCreateInfo.arrayLayers = 1;
+        imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageCreateInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+        imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+        if (vkCreateImage(m_VkDevice, &imageCreateInfo, NULL, &m_RenderTarget) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create render target");
+        }
+
+        VkMemoryRequirements memoryRequirements;
+        vkGetImageMemoryRequirements(m_VkDevice, m_RenderTarget, &memoryRequirements);
+        auto memoryType = m_GPU->FindMemoryType(memoryRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+        if (!memoryType.has_value()) { throw std::runtime_error("no suitable memory type for render target"); }
+
+        VkMemoryAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocInfo.allocationSize = memoryRequirements.size;
+        allocInfo.memoryTypeIndex = memoryType.value();
+
+        {
+            ResourceStats::CategoryScope category(MemoryCategory::RenderTarget);
+
+            if (vkAllocateMemory(m_VkDevice, &allocInfo, NULL, &m_RenderTargetMemory) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to allocate render target memory");
+            }
+        }
+
+        vkBindImageMemory(m_VkDevice, m_RenderTarget, m_RenderTargetMemory, 0);
+
+        VkImageViewCreateInfo viewCreateInfo{};
+        viewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewCreateInfo.image = m_RenderTarget;
+        viewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewCreateInfo.format = format;
+        viewCreateInfo.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
+        viewCreateInfo.components.g = VK_COMPONENT_SWIZZLE_IDENTITY;
+        viewCreateInfo.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
+        viewCreateInfo.components.a = VK_COMPONENT_SWIZZLE_IDENTITY;
+        viewCreateInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        viewCreateInfo.subresourceRange.baseMipLevel = 0;
+        viewCreateInfo.subresourceRange.levelCount = 1;
+        viewCreateInfo.subresourceRange.baseArrayLayer = 0;
+        viewCreateInfo.subresourceRange.layerCount = 1;
+
+        if (vkCreateImageView(m_VkDevice, &viewCreateInfo, NULL, &m_RenderTargetView) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create render target view");
+        }
+    }
+
+    VkFormat App::ChooseDepthFormat() const
+    {
+        // D32 is the only one of these that isn't optional, but some drivers only have the packed formats
+        for (VkFormat format : {VK_FORMAT_D32_SFLOAT, VK_FORMAT_D32_SFLOAT_S8_UINT, VK_FORMAT_D24_UNORM_S8_UINT})
+        {
+            if (m_GPU->GetOptimalTilingFeatures(format) & VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT)
+            {
+                return format;
+            }
+        }
+
+        throw std::runtime_error("no supported depth format");
+    }
+
+    void App::CreateDepthBuffer()
+    {
+        VkFormat format = ChooseDepthFormat();
+        VkExtent2D extent{};
+
+        // one depth buffer serves every window, they're rendered one after another
+        for (const auto& window : m_Windows)
+        {
+            extent.width = std::max(extent.width, window.extent.width);
+            extent.height = std::max(extent.height, window.extent.height);
+        }
+
+        VkImageCreateInfo imageCreateInfo{};
+        imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageCreateInfo.format = format;
+        imageCreateInfo.extent.width = extent.width;
+        imageCreateInfo.extent.height = extent.height;
+        imageCreateInfo.extent.depth = 1;
+        imageCreateInfo.mipLevels = 1;
+        imageCreateInfo.arrayLayers = 1;
+        imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageCreateInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+        imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+        if (vkCreateImage(m_VkDevice, &imageCreateInfo, NULL, &m_DepthImage) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create depth buffer");
+        }
+
+        VkMemoryRequirements memoryRequirements;
+        vkGetImageMemoryRequirements(m_VkDevice, m_DepthImage, &memoryRequirements);
+        auto memoryType = m_GPU->FindMemoryType(memoryRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+        if (!memoryType.has_value()) { throw std::runtime_error("no suitable memory type for depth buffer"); }
+
+        VkMemoryAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocInfo.allocationSize = memoryRequirements.size;
+        allocInfo.memoryTypeIndex = memoryType.value();
+
+        {
+            ResourceStats::CategoryScope category(MemoryCategory::RenderTarget);
+
+            if (vkAllocateMemory(m_VkDevice, &allocInfo, NULL, &m_DepthMemory) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to allocate depth buffer memory");
+            }
+        }
 
-        for (size_t i = 0; i < m_SwapChainImageViews.size(); i++)
+        vkBindImageMemory(m_VkDevice, m_DepthImage, m_DepthMemory, 0);
+
+        VkImageViewCreateInfo viewCreateInfo{};
+        viewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewCreateInfo.image = m_DepthImage;
+        viewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewCreateInfo.format = format;
+        viewCreateInfo.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
+        viewCreateInfo.components.g = VK_COMPONENT_SWIZZLE_IDENTITY;
+        viewCreateInfo.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
+        viewCreateInfo.components.a = VK_COMPONENT_SWIZZLE_IDENTITY;
+        viewCreateInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+        viewCreateInfo.subresourceRange.baseMipLevel = 0;
+        viewCreateInfo.subresourceRange.levelCount = 1;
+        viewCreateInfo.subresourceRange.baseArrayLayer = 0;
+        viewCreateInfo.subresourceRange.layerCount = 1;
+
+        if (vkCreateImageView(m_VkDevice, &viewCreateInfo, NULL, &m_DepthView) != VK_SUCCESS)
         {
-            VkImageView attachments[] = {m_SwapChainImageViews[i]};
+            throw std::runtime_error("failed to create depth buffer view");
+        }
+    }
+
+    void App::CreateFramebuffers()
+    {
+        auto createFramebuffer = [this](VkImageView attachment, VkExtent2D extent)
+        {
+            // the depth buffer is as big as the largest window, so it fits every framebuffer
+            VkImageView attachments[] = {attachment, m_DepthView};
 
             VkFramebufferCreateInfo framebufferCreateInfo{};
             framebufferCreateInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
             framebufferCreateInfo.renderPass = m_RenderPass;
-            framebufferCreateInfo.attachmentCount = 1;
+            framebufferCreateInfo.attachmentCount = 2;
             framebufferCreateInfo.pAttachments = attachments;
-            framebufferCreateInfo.width = m_SwapChainExtent.width;
-            framebufferCreateInfo.height = m_SwapChainExtent.height;
+            framebufferCreateInfo.width = extent.width;
+            framebufferCreateInfo.height = extent.height;
             framebufferCreateInfo.layers = 1;
 
-            if (vkCreateFramebuffer(m_VkDevice, &framebufferCreateInfo, NULL, &m_Framebuffers[i]) != VK_SUCCESS)
+            VkFramebuffer framebuffer;
+
+            if (vkCreateFramebuffer(m_VkDevice, &framebufferCreateInfo, NULL, &framebuffer) != VK_SUCCESS)
             {
                 throw std::runtime_error("failed to create framebuffer");
             }
+
+            return framebuffer;
+        };
+
+        // a single framebuffer over the render target shared by every window, or one per swapchain image
+        if (m_Settings.dynamicResolution)
+        {
+            m_RenderTargetFramebuffer = createFramebuffer(m_RenderTargetView, m_RenderTargetExtent);
+            return;
+        }
+
+        for (auto& window : m_Windows)
+        {
+            for (auto imageView : window.imageViews)
+            {
+                window.framebuffers.push_back(createFramebuffer(imageView, window.extent));
+            }
         }
     }
 
@@ -254,4 +629,263 @@ namespace VkTest
             throw std::runtime_error("failed to allocate command buffers");
         }
     }
+    void App::CreateSyncObjects()
+    {
+        VkSemaphoreCreateInfo semaphoreCreateInfo{};
+        semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+        // a single present waits on one semaphore for all swapchains, but each acquire needs its own
+        if (vkCreateSemaphore(m_VkDevice, &semaphoreCreateInfo, NULL, &m_RenderFinishedSemaphore) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create sync objects");
+        }
+
+        for (auto& window : m_Windows)
+        {
+            if (vkCreateSemaphore(m_VkDevice, &semaphoreCreateInfo, NULL, &window.imageAvailable) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to create sync objects");
+            }
+        }
+    }
+
+    void App::RecordCommandBuffer()
+    {
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+        if (vkBeginCommandBuffer(m_CommandBuffer, &beginInfo) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to begin recording command buffer");
+        }
+
+        // windows reuse the render target one after another, the render pass dependencies order the blits and the next pass
+        for (const auto& window : m_Windows)
+        {
+            RecordWindow(window);
+        }
+
+        if (vkEndCommandBuffer(m_CommandBuffer) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to record command buffer");
+        }
+    }
+
+    void App::RecordWindow(const Window& window)
+    {
+        VkExtent2D renderExtent = m_Settings.dynamicResolution ? m_ResolutionScaler.GetRenderExtent(window.extent) : window.extent;
+
+        VkClearValue clearValues[2]{};
+        clearValues[0].color = {{0.0f, 0.0f, 0.0f, 1.0f}};
+        clearValues[1].depthStencil = {1.0f, 0};
+
+        VkRenderPassBeginInfo renderPassBeginInfo{};
+        renderPassBeginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        renderPassBeginInfo.renderPass = m_RenderPass;
+        renderPassBeginInfo.framebuffer = m_Settings.dynamicResolution ? m_RenderTargetFramebuffer : window.framebuffers[window.imageIndex];
+        renderPassBeginInfo.renderArea.offset = {0, 0};
+        renderPassBeginInfo.renderArea.extent = renderExtent;
+        renderPassBeginInfo.clearValueCount = 2;
+        renderPassBeginInfo.pClearValues = clearValues;
+
+        vkCmdBeginRenderPass(m_CommandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+
+        VkViewport viewport{};
+        viewport.x = 0.0f;
+        viewport.y = 0.0f;
+        viewport.width = static_cast<float>(renderExtent.width);
+        viewport.height = static_cast<float>(renderExtent.height);
+        viewport.minDepth = 0.0f;
+        viewport.maxDepth = 1.0f;
+        vkCmdSetViewport(m_CommandBuffer, 0, 1, &viewport);
+
+        VkRect2D scissor{};
+        scissor.offset = {0, 0};
+        scissor.extent = renderExtent;
+        vkCmdSetScissor(m_CommandBuffer, 0, 1, &scissor);
+
+        // the sorted opaques come first, so the prepass is just a prefix of the list
+        if (m_Settings.depthPrepass)
+        {
+            vkCmdBindPipeline(m_CommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_DepthPipeline);
+
+            for (std::size_t i = 0; i < m_DrawList.GetOpaqueCount(); ++i)
+            {
+                const Draw& draw = m_DrawList[i];
+                vkCmdDraw(m_CommandBuffer, draw.vertexCount, draw.instanceCount, draw.firstVertex, draw.firstInstance);
+            }
+
+            vkCmdNextSubpass(m_CommandBuffer, VK_SUBPASS_CONTENTS_INLINE);
+        }
+
+        // materials don't have any bindings yet, they only keep equal state together in the sort.
+        // a draw's pipeline index picks the same entry in both tables, transparency picks the table
+        std::array<VkPipeline, 1> pipelines = {m_Pipeline};
+        std::array<VkPipeline, 1> transparentPipelines = {m_TransparentPipeline};
+        VkPipeline boundPipeline = VK_NULL_HANDLE;
+
+        for (std::size_t i = 0; i < m_DrawList.GetSize(); ++i)
+        {
+            const Draw& draw = m_DrawList[i];
+            const auto& table = draw.transparent ? transparentPipelines : pipelines;
+
+            if (draw.pipeline >= table.size())
+            {
+                throw std::runtime_error("draw uses pipeline " + std::to_string(draw.pipeline) + ", which doesn't exist");
+            }
+
+            if (table[draw.pipeline] != boundPipeline)
+            {
+                boundPipeline = table[draw.pipeline];
+                vkCmdBindPipeline(m_CommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, boundPipeline);
+            }
+
+            vkCmdDraw(m_CommandBuffer, draw.vertexCount, draw.instanceCount, draw.firstVertex, draw.firstInstance);
+        }
+
+        vkCmdEndRenderPass(m_CommandBuffer);
+
+        if (m_Settings.dynamicResolution)
+        {
+            VkImageMemoryBarrier barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            barrier.srcAccessMask = 0;
+            barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.image = window.images[window.imageIndex];
+            barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            barrier.subresourceRange.baseMipLevel = 0;
+            barrier.subresourceRange.levelCount = 1;
+            barrier.subresourceRange.baseArrayLayer = 0;
+            barrier.subresourceRange.layerCount = 1;
+            vkCmdPipelineBarrier(m_CommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+            VkImageBlit blit{};
+            blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            blit.srcSubresource.mipLevel = 0;
+            blit.srcSubresource.baseArrayLayer = 0;
+            blit.srcSubresource.layerCount = 1;
+            blit.srcOffsets[1] = {static_cast<std::int32_t>(renderExtent.width), static_cast<std::int32_t>(renderExtent.height), 1};
+            blit.dstSubresource = blit.srcSubresource;
+            blit.dstOffsets[1] = {static_cast<std::int32_t>(window.extent.width), static_cast<std::int32_t>(window.extent.height), 1};
+            vkCmdBlitImage(m_CommandBuffer, m_RenderTarget, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, window.images[window.imageIndex], VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, m_BlitFilter);
+
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = 0;
+            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            barrier.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+            vkCmdPipelineBarrier(m_CommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+        }
+    }
+
+    void App::DrawFrame()
+    {
+        // the graphics timeline replaces the in-flight fence
+        m_Scheduler->Wait(m_GraphicsQueueId, m_LastFrameValue);
+        m_DeletionQueue.Collect(*m_Scheduler);
+
+        if (m_ShaderWatcher)
+        {
+            SwapPendingPipeline();
+        }
+
+        for (auto& window : m_Windows)
+        {
+            // suboptimal still hands back an image that can be presented
+            VkResult result = vkAcquireNextImageKHR(m_VkDevice, window.swapChain, UINT64_MAX, window.imageAvailable, VK_NULL_HANDLE, &window.imageIndex);
+
+            if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR)
+            {
+                throw std::runtime_error("failed to acquire swapchain image");
+            }
+        }
+
+        if (m_Settings.dynamicResolution)
+        {
+            m_ResolutionScaler.Update();
+        }
+
+        // the scene is the one triangle for now, drawn through the same path a bigger scene would use
+        m_DrawList.Clear();
+        m_DrawList.Add({0, 0, false, 0.0f, 3, 1, 0, 0});
+        m_DrawList.Sort(*m_ThreadPool);
+
+        vkResetCommandBuffer(m_CommandBuffer, 0);
+        RecordCommandBuffer();
+
+        SubmitBatch batch(m_Scheduler->GetBatchMemory());
+        batch.commandBuffers.push_back(m_CommandBuffer);
+
+        for (const auto& window : m_Windows)
+        {
+            batch.waits.push_back({window.imageAvailable, 0, m_Settings.dynamicResolution ? VK_PIPELINE_STAGE_2_TRANSFER_BIT : VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT});
+        }
+
+        batch.waits.insert(batch.waits.end(), m_PendingComputeWaits.begin(), m_PendingComputeWaits.end());
+        batch.signals.push_back({m_RenderFinishedSemaphore, 0, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT});
+        m_PendingComputeWaits.clear();
+
+        m_LastFrameValue = m_Scheduler->GetPendingValue(m_GraphicsQueueId);
+        m_Scheduler->Enqueue(m_GraphicsQueueId, std::move(batch));
+        m_Scheduler->Flush();
+
+        std::pmr::vector<VkSwapchainKHR> swapChains(&m_FrameArena);
+        std::pmr::vector<std::uint32_t> imageIndices(&m_FrameArena);
+        std::pmr::vector<VkResult> presentResults(m_Windows.size(), VK_SUCCESS, &m_FrameArena);
+
+        for (const auto& window : m_Windows)
+        {
+            swapChains.push_back(window.swapChain);
+            imageIndices.push_back(window.imageIndex);
+        }
+
+        // every window goes out in one call, the call's own result only reports the worst of them
+        VkPresentInfoKHR presentInfo{};
+        presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+        presentInfo.waitSemaphoreCount = 1;
+        presentInfo.pWaitSemaphores = &m_RenderFinishedSemaphore;
+        presentInfo.swapchainCount = static_cast<std::uint32_t>(swapChains.size());
+        presentInfo.pSwapchains = swapChains.data();
+        presentInfo.pImageIndices = imageIndices.data();
+        presentInfo.pResults = presentResults.data();
+        VkResult presentResult = vkQueuePresentKHR(m_PresentQueue, &presentInfo);
+
+        if (presentResult != VK_SUCCESS && presentResult != VK_SUBOPTIMAL_KHR)
+        {
+            for (std::size_t i = 0; i < presentResults.size(); ++i)
+            {
+                if (presentResults[i] != VK_SUCCESS && presentResults[i] != VK_SUBOPTIMAL_KHR)
+                {
+                    throw std::runtime_error("failed to present swapchain image for window " + std::to_string(i));
+                }
+            }
+
+            throw std::runtime_error("failed to present swapchain images");
+        }
+
+        m_FrameArena.Reset();
+        ++m_FrameCount;
+
+        if (m_ResourceStats)
+        {
+            EndFrameStats();
+        }
+    }
+
+    void App::EndFrameStats()
+    {
+        m_ResourceStats->EndFrame(m_Settings.budgetSampleInterval > 0 && m_FrameCount % m_Settings.budgetSampleInterval == 0, m_LastFrameHeapAllocations);
+
+        if (!m_Settings.statsPath.empty() && m_Settings.statsDumpInterval > 0 && m_FrameCount % m_Settings.statsDumpInterval == 0)
+        {
+            if (!m_ResourceStats->WriteJson(m_Settings.statsPath))
+            {
+                std::cerr << "Couldn't write resource stats to '" << m_Settings.statsPath << "'\n";
+            }
+        }
+    }
 }
\ No newline at end of file
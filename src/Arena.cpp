@@ -0,0 +1,168 @@
+#include "VkTest/Arena.h"
+
+#include <atomic>
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <new>
+
+namespace VkTest
+{
+    namespace
+    {
+        std::atomic<std::uint64_t> g_GlobalAllocations = 0;
+        std::atomic<std::uint64_t> g_UpstreamAllocations = 0;
+    }
+
+    Arena::Arena(std::size_t blockSize, std::pmr::memory_resource* upstream) noexcept : m_Upstream(upstream), m_BlockSize(blockSize), m_Current(0), m_Offset(0)
+    {
+    }
+
+    Arena::~Arena() noexcept
+    {
+        for (const auto& block : m_Blocks)
+        {
+            m_Upstream->deallocate(block.data, block.size, alignof(std::max_align_t));
+        }
+    }
+
+    void* Arena::do_allocate(std::size_t bytes, std::size_t alignment)
+    {
+        while (true)
+        {
+            if (m_Current == m_Blocks.size())
+            {
+                // big enough for the request at any alignment, so the loop ends here
+                if (bytes > std::numeric_limits<std::size_t>::max() - alignment) { throw std::bad_alloc(); }
+
+                std::size_t size = std::max(m_BlockSize, bytes + alignment);
+                m_Blocks.push_back({static_cast<std::byte*>(m_Upstream->allocate(size, alignof(std::max_align_t))), size});
+                g_UpstreamAllocations.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            const Block& block = m_Blocks[m_Current];
+            std::uintptr_t base = reinterpret_cast<std::uintptr_t>(block.data);
+            std::size_t offset = static_cast<std::size_t>(((base + m_Offset + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1)) - base);
+
+            // compared without adding, a huge request would wrap and appear to fit
+            if (bytes <= block.size && offset <= block.size - bytes)
+            {
+                m_Offset = offset + bytes;
+                return block.data + offset;
+            }
+
+            // the rest of this block is wasted until the next rewind
+            ++m_Current;
+            m_Offset = 0;
+        }
+    }
+
+    std::size_t Arena::GetCapacity() const noexcept
+    {
+        std::size_t capacity = 0;
+
+        for (const auto& block : m_Blocks)
+        {
+            capacity += block.size;
+        }
+
+        return capacity;
+    }
+
+    Arena& Arena::GetThreadArena()
+    {
+        thread_local Arena arena;
+        return arena;
+    }
+
+    std::uint64_t Arena::GetUpstreamAllocationCount() noexcept
+    {
+        return g_UpstreamAllocations.load(std::memory_order_relaxed);
+    }
+
+    std::uint64_t GetGlobalAllocationCount() noexcept
+    {
+        return g_GlobalAllocations.load(std::memory_order_relaxed);
+    }
+
+    namespace
+    {
+        void* AllocateGlobal(std::size_t size, std::size_t alignment)
+        {
+            g_GlobalAllocations.fetch_add(1, std::memory_order_relaxed);
+
+            bool overAligned = alignment > alignof(std::max_align_t);
+
+            if (overAligned)
+            {
+                // aligned_alloc wants the size to be a multiple of the alignment, rounding up mustn't wrap
+                if (size > std::numeric_limits<std::size_t>::max() - (alignment - 1)) { throw std::bad_alloc(); }
+
+                size = std::max<std::size_t>((size + alignment - 1) & ~(alignment - 1), alignment);
+            }
+            else if (size == 0)
+            {
+                // new has to return a unique pointer even for zero bytes, malloc(0) may return null
+                size = 1;
+            }
+
+            while (true)
+            {
+            #ifdef _WIN32
+                void* memory = overAligned ? _aligned_malloc(size, alignment) : std::malloc(size);
+            #else
+                void* memory = overAligned ? std::aligned_alloc(alignment, size) : std::malloc(size);
+            #endif
+
+                if (memory != nullptr) { return memory; }
+
+                std::new_handler handler = std::get_new_handler();
+
+                if (handler == nullptr) { throw std::bad_alloc(); }
+
+                handler();
+            }
+        }
+
+        void FreeGlobal(void* memory, std::size_t alignment) noexcept
+        {
+        #ifdef _WIN32
+            if (alignment > alignof(std::max_align_t)) { _aligned_free(memory); return; }
+        #else
+            (void)alignment;
+        #endif
+            std::free(memory);
+        }
+    }
+}
+
+// the array and nothrow forms forward to these by default, so this covers every new expression
+void* operator new(std::size_t size)
+{
+    return VkTest::AllocateGlobal(size, alignof(std::max_align_t));
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    return VkTest::AllocateGlobal(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* memory) noexcept
+{
+    VkTest::FreeGlobal(memory, alignof(std::max_align_t));
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    VkTest::FreeGlobal(memory, alignof(std::max_align_t));
+}
+
+void operator delete(void* memory, std::align_val_t alignment) noexcept
+{
+    VkTest::FreeGlobal(memory, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t alignment) noexcept
+{
+    VkTest::FreeGlobal(memory, static_cast<std::size_t>(alignment));
+}
\ No newline at end of file
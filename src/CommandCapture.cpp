@@ -0,0 +1,868 @@
+#include "VkTest/CommandCapture.h"
+#include "VkTest/VolkHook.h"
+
+#include <iostream>
+#include <type_traits>
+
+namespace VkTest
+{
+    namespace
+    {
+        CommandCapture* g_Capture = nullptr;
+
+        // the writer is handed to the file once it grows past this
+        constexpr std::size_t kFlushSize = 1 << 20;
+
+        template<auto* Slot>
+        using Hook = VolkHook<CommandCapture, Slot>;
+
+        // dispatchable handles are pointers, non-dispatchable ones are 64-bit integers on 32-bit platforms
+        template<typename Handle>
+        std::uint64_t ToKey(Handle handle) noexcept
+        {
+            if constexpr (std::is_pointer_v<Handle>) { return static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(handle)); }
+            else { return static_cast<std::uint64_t>(handle); }
+        }
+
+        // structs are written with their chains cut, extensions aren't captured
+        template<typename T>
+        T Strip(T value) noexcept
+        {
+            value.pNext = nullptr;
+            return value;
+        }
+
+        // holds the capture locked while a hook writes one record. without an op it only takes the
+        // lock, so a hook can look things up and refuse its input before Open writes anything
+        class Record
+        {
+        private:
+            CommandCapture* m_Capture;
+            bool m_Open;
+        public:
+            Record() : m_Capture(g_Capture->Lock() ? g_Capture : nullptr), m_Open(false) {}
+            Record(CaptureOp op) : Record() { if (m_Capture != nullptr) { Open(op); } }
+
+            ~Record() noexcept
+            {
+                if (m_Capture == nullptr) { return; }
+                if (m_Open) { m_Capture->GetWriter().End(); }
+                m_Capture->Unlock();
+            }
+
+            Record(const Record&) = delete;
+            Record& operator=(const Record&) = delete;
+
+            explicit operator bool() const noexcept { return m_Capture != nullptr; }
+            CommandCapture& GetCapture() noexcept { return *m_Capture; }
+
+            void Open(CaptureOp op)
+            {
+                m_Capture->GetWriter().Begin(op);
+                m_Open = true;
+            }
+
+            template<typename T>
+            void Write(const T& value) { m_Capture->GetWriter().Write(value); }
+
+            template<typename T>
+            void WriteArray(const T* values, std::uint32_t count) { m_Capture->GetWriter().WriteArray(values, count); }
+
+            void WriteString(const char* value) { m_Capture->GetWriter().WriteString(value); }
+
+            template<typename Handle>
+            void WriteNewId(VkObjectType type, Handle handle) { Write(m_Capture->AssignId(type, ToKey(handle))); }
+
+            template<typename Handle>
+            void WriteId(VkObjectType type, Handle handle) { Write(m_Capture->GetId(type, ToKey(handle))); }
+
+            template<typename Handle>
+            void WriteDestroy(VkObjectType type, Handle handle)
+            {
+                Write(type);
+                Write(m_Capture->ReleaseId(type, ToKey(handle)));
+            }
+        };
+
+        // recorded before the call so another thread can't be handed the same handle in between
+        template<auto* Slot, VkObjectType Type, typename Handle>
+        VKAPI_ATTR void VKAPI_CALL DestroyHook(VkDevice device, Handle handle, const VkAllocationCallbacks* pAllocator)
+        {
+            if (handle != VK_NULL_HANDLE)
+            {
+                if (Record record(CaptureOp::Destroy); record) { record.WriteDestroy(Type, handle); }
+            }
+
+            Hook<Slot>::CallOriginal(device, handle, pAllocator);
+        }
+
+        VKAPI_ATTR VkResult VKAPI_CALL CreateImageHook(VkDevice device, const VkImageCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkImage* pImage)
+        {
+            VkResult result = Hook<&vkCreateImage>::CallOriginal(device, pCreateInfo, pAllocator, pImage);
+            if (result != VK_SUCCESS) { return result; }
+
+            if (Record record(CaptureOp::CreateImage); record)
+            {
+                // the replay owns a single queue
+                VkImageCreateInfo info = Strip(*pCreateInfo);
+                info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+                info.queueFamilyIndexCount = 0;
+                info.pQueueFamilyIndices = nullptr;
+                record.WriteNewId(VK_OBJECT_TYPE_IMAGE, *pImage);
+                record.Write(info);
+            }
+
+            return result;
+        }
+
+        VKAPI_ATTR VkResult VKAPI_CALL AllocateMemoryHook(VkDevice device, const VkMemoryAllocateInfo* pAllocateInfo, const VkAllocationCallbacks* pAllocator, VkDeviceMemory* pMemory)
+        {
+            VkResult result = Hook<&vkAllocateMemory>::CallOriginal(device, pAllocateInfo, pAllocator, pMemory);
+            if (result != VK_SUCCESS) { return result; }
+
+            // memory type indices don't carry over between devices, the replay picks one with the same properties
+            if (Record record(CaptureOp::AllocateMemory); record)
+            {
+                record.WriteNewId(VK_OBJECT_TYPE_DEVICE_MEMORY, *pMemory);
+                record.Write(pAllocateInfo->allocationSize);
+                record.Write(record.GetCapture().GetMemoryPropertyFlags(pAllocateInfo->memoryTypeIndex));
+            }
+
+            return result;
+        }
+
+        VKAPI_ATTR VkResult VKAPI_CALL BindImageMemoryHook(VkDevice device, VkImage image, VkDeviceMemory memory, VkDeviceSize memoryOffset)
+        {
+            VkResult result = Hook<&vkBindImageMemory>::CallOriginal(device, image, memory, memoryOffset);
+            if (result != VK_SUCCESS) { return result; }
+
+            if (Record record(CaptureOp::BindImageMemory); record)
+            {
+                record.WriteId(VK_OBJECT_TYPE_IMAGE, image);
+                record.WriteId(VK_OBJECT_TYPE_DEVICE_MEMORY, memory);
+                record.Write(memoryOffset);
+            }
+
+            return result;
+        }
+
+        VKAPI_ATTR VkResult VKAPI_CALL CreateImageViewHook(VkDevice device, const VkImageViewCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkImageView* pView)
+        {
+            VkResult result = Hook<&vkCreateImageView>::CallOriginal(device, pCreateInfo, pAllocator, pView);
+            if (result != VK_SUCCESS) { return result; }
+
+            if (Record record(CaptureOp::CreateImageView); record)
+            {
+                VkImageViewCreateInfo info = Strip(*pCreateInfo);
+                info.image = VK_NULL_HANDLE;
+                record.WriteNewId(VK_OBJECT_TYPE_IMAGE_VIEW, *pView);
+                record.WriteId(VK_OBJECT_TYPE_IMAGE, pCreateInfo->image);
+                record.Write(info);
+            }
+
+            return result;
+        }
+
+        VKAPI_ATTR VkResult VKAPI_CALL CreateShaderModuleHook(VkDevice device, const VkShaderModuleCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkShaderModule* pShaderModule)
+        {
+            VkResult result = Hook<&vkCreateShaderModule>::CallOriginal(device, pCreateInfo, pAllocator, pShaderModule);
+            if (result != VK_SUCCESS) { return result; }
+
+            if (Record record(CaptureOp::CreateShaderModule); record)
+            {
+                record.WriteNewId(VK_OBJECT_TYPE_SHADER_MODULE, *pShaderModule);
+                record.Write(pCreateInfo->flags);
+                record.WriteArray(pCreateInfo->pCode, static_cast<std::uint32_t>(pCreateInfo->codeSize / sizeof(std::uint32_t)));
+            }
+
+            return result;
+        }
+
+        VKAPI_ATTR VkResult VKAPI_CALL CreatePipelineLayoutHook(VkDevice device, const VkPipelineLayoutCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkPipelineLayout* pPipelineLayout)
+        {
+            // descriptor set layouts aren't captured, VkTest doesn't use any yet. unsupported input is
+            // refused before the call, so nothing gets created or half written into the capture.
+            // once the capture has stopped there's nothing to protect
+            if (pCreateInfo->setLayoutCount > 0 && g_Capture->IsActive())
+            {
+                throw std::runtime_error("capture doesn't support descriptor set layouts");
+            }
+
+            VkResult result = Hook<&vkCreatePipelineLayout>::CallOriginal(device, pCreateInfo, pAllocator, pPipelineLayout);
+            if (result != VK_SUCCESS) { return result; }
+
+            if (Record record(CaptureOp::CreatePipelineLayout); record)
+            {
+                record.WriteNewId(VK_OBJECT_TYPE_PIPELINE_LAYOUT, *pPipelineLayout);
+                record.Write(pCreateInfo->flags);
+                record.WriteArray(pCreateInfo->pPushConstantRanges, pCreateInfo->pushConstantRangeCount);
+            }
+
+            return result;
+        }
+
+        VKAPI_ATTR VkResult VKAPI_CALL CreateRenderPassHook(VkDevice device, const VkRenderPassCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkRenderPass* pRenderPass)
+        {
+            VkResult result = Hook<&vkCreateRenderPass>::CallOriginal(device, pCreateInfo, pAllocator, pRenderPass);
+            if (result != VK_SUCCESS) { return result; }
+
+            if (Record record(CaptureOp::CreateRenderPass); record)
+            {
+                record.WriteNewId(VK_OBJECT_TYPE_RENDER_PASS, *pRenderPass);
+                record.Write(pCreateInfo->flags);
+                record.WriteArray(pCreateInfo->pAttachments, pCreateInfo->attachmentCount);
+                record.Write(pCreateInfo->subpassCount);
+
+                for (std::uint32_t i = 0; i < pCreateInfo->subpassCount; ++i)
+                {
+                    const VkSubpassDescription& subpass = pCreateInfo->pSubpasses[i];
+                    record.Write(subpass.flags);
+                    record.Write(subpass.pipelineBindPoint);
+                    record.WriteArray(subpass.pInputAttachments, subpass.inputAttachmentCount);
+                    record.WriteArray(subpass.pColorAttachments, subpass.colorAttachmentCount);
+                    record.WriteArray(subpass.pResolveAttachments, subpass.colorAttachmentCount);
+                    record.WriteArray(subpass.pDepthStencilAttachment, 1);
+                    record.WriteArray(subpass.pPreserveAttachments, subpass.preserveAttachmentCount);
+                }
+
+                record.WriteArray(pCreateInfo->pDependencies, pCreateInfo->dependencyCount);
+            }
+
+            return result;
+        }
+
+        VKAPI_ATTR VkResult VKAPI_CALL CreateFramebufferHook(VkDevice device, const VkFramebufferCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkFramebuffer* pFramebuffer)
+        {
+            VkResult result = Hook<&vkCreateFramebuffer>::CallOriginal(device, pCreateInfo, pAllocator, pFramebuffer);
+            if (result != VK_SUCCESS) { return result; }
+
+            if (Record record(CaptureOp::CreateFramebuffer); record)
+            {
+                record.WriteNewId(VK_OBJECT_TYPE_FRAMEBUFFER, *pFramebuffer);
+                record.Write(pCreateInfo->flags);
+                record.WriteId(VK_OBJECT_TYPE_RENDER_PASS, pCreateInfo->renderPass);
+                record.Write(pCreateInfo->attachmentCount);
+
+                for (std::uint32_t i = 0; i < pCreateInfo->attachmentCount; ++i)
+                {
+                    record.WriteId(VK_OBJECT_TYPE_IMAGE_VIEW, pCreateInfo->pAttachments[i]);
+                }
+
+                record.Write(pCreateInfo->width);
+                record.Write(pCreateInfo->height);
+                record.Write(pCreateInfo->layers);
+            }
+
+            return result;
+        }
+
+        // optional states are written as a present flag followed by the stripped struct
+        template<typename T>
+        void WriteState(Record& record, const T* state)
+        {
+            record.Write(static_cast<std::uint8_t>(state != nullptr));
+            if (state != nullptr) { record.Write(Strip(*state)); }
+        }
+
+        // specialization constants and tessellation state aren't captured
+        void WriteGraphicsPipeline(Record& record, const VkGraphicsPipelineCreateInfo& info)
+        {
+            record.Write(info.flags);
+            record.Write(info.stageCount);
+
+            for (std::uint32_t i = 0; i < info.stageCount; ++i)
+            {
+                const VkPipelineShaderStageCreateInfo& stage = info.pStages[i];
+                record.Write(stage.flags);
+                record.Write(stage.stage);
+                record.WriteId(VK_OBJECT_TYPE_SHADER_MODULE, stage.module);
+                record.WriteString(stage.pName);
+            }
+
+            const VkPipelineVertexInputStateCreateInfo* vertexInput = info.pVertexInputState;
+            record.WriteArray(vertexInput != nullptr ? vertexInput->pVertexBindingDescriptions : nullptr, vertexInput != nullptr ? vertexInput->vertexBindingDescriptionCount : 0);
+            record.WriteArray(vertexInput != nullptr ? vertexInput->pVertexAttributeDescriptions : nullptr, vertexInput != nullptr ? vertexInput->vertexAttributeDescriptionCount : 0);
+            WriteState(record, info.pInputAssemblyState);
+
+            const VkPipelineViewportStateCreateInfo* viewport = info.pViewportState;
+            record.Write(static_cast<std::uint8_t>(viewport != nullptr));
+
+            if (viewport != nullptr)
+            {
+                record.Write(viewport->viewportCount);
+                record.Write(viewport->scissorCount);
+                record.WriteArray(viewport->pViewports, viewport->viewportCount);
+                record.WriteArray(viewport->pScissors, viewport->scissorCount);
+            }
+
+            WriteState(record, info.pRasterizationState);
+            WriteState(record, info.pMultisampleState);
+            WriteState(record, info.pDepthStencilState);
+
+            const VkPipelineColorBlendStateCreateInfo* colorBlend = info.pColorBlendState;
+            record.Write(static_cast<std::uint8_t>(colorBlend != nullptr));
+
+            if (colorBlend != nullptr)
+            {
+                VkPipelineColorBlendStateCreateInfo state = Strip(*colorBlend);
+                state.pAttachments = nullptr;
+                record.Write(state);
+                record.WriteArray(colorBlend->pAttachments, colorBlend->attachmentCount);
+            }
+
+            const VkPipelineDynamicStateCreateInfo* dynamic = info.pDynamicState;
+            record.WriteArray(dynamic != nullptr ? dynamic->pDynamicStates : nullptr, dynamic != nullptr ? dynamic->dynamicStateCount : 0);
+
+            record.WriteId(VK_OBJECT_TYPE_PIPELINE_LAYOUT, info.layout);
+            record.WriteId(VK_OBJECT_TYPE_RENDER_PASS, info.renderPass);
+            record.Write(info.subpass);
+        }
+
+        VKAPI_ATTR VkResult VKAPI_CALL CreateGraphicsPipelinesHook(VkDevice device, VkPipelineCache cache, std::uint32_t count, const VkGraphicsPipelineCreateInfo* pCreateInfos, const VkAllocationCallbacks* pAllocator, VkPipeline* pPipelines)
+        {
+            bool active = g_Capture->IsActive();
+
+            for (std::uint32_t i = 0; active && i < count; ++i)
+            {
+                if (pCreateInfos[i].pMultisampleState != nullptr && pCreateInfos[i].pMultisampleState->pSampleMask != nullptr)
+                {
+                    throw std::runtime_error("capture doesn't support sample masks");
+                }
+            }
+
+            VkResult result = Hook<&vkCreateGraphicsPipelines>::CallOriginal(device, cache, count, pCreateInfos, pAllocator, pPipelines);
+
+            // failed creations leave VK_NULL_HANDLE in their slot
+            for (std::uint32_t i = 0; i < count; ++i)
+            {
+                if (pPipelines[i] == VK_NULL_HANDLE) { continue; }
+
+                if (Record record(CaptureOp::CreateGraphicsPipeline); record)
+                {
+                    record.WriteNewId(VK_OBJECT_TYPE_PIPELINE, pPipelines[i]);
+                    WriteGraphicsPipeline(record, pCreateInfos[i]);
+                }
+            }
+
+            return result;
+        }
+
+        VKAPI_ATTR VkResult VKAPI_CALL CreateCommandPoolHook(VkDevice device, const VkCommandPoolCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkCommandPool* pCommandPool)
+        {
+            VkResult result = Hook<&vkCreateCommandPool>::CallOriginal(device, pCreateInfo, pAllocator, pCommandPool);
+            if (result != VK_SUCCESS) { return result; }
+
+            if (Record record(CaptureOp::CreateCommandPool); record)
+            {
+                record.WriteNewId(VK_OBJECT_TYPE_COMMAND_POOL, *pCommandPool);
+                record.Write(pCreateInfo->flags);
+            }
+
+            return result;
+        }
+
+        VKAPI_ATTR VkResult VKAPI_CALL AllocateCommandBuffersHook(VkDevice device, const VkCommandBufferAllocateInfo* pAllocateInfo, VkCommandBuffer* pCommandBuffers)
+        {
+            VkResult result = Hook<&vkAllocateCommandBuffers>::CallOriginal(device, pAllocateInfo, pCommandBuffers);
+            if (result != VK_SUCCESS) { return result; }
+
+            if (Record record(CaptureOp::AllocateCommandBuffer); record)
+            {
+                record.WriteId(VK_OBJECT_TYPE_COMMAND_POOL, pAllocateInfo->commandPool);
+                record.Write(pAllocateInfo->level);
+                record.Write(pAllocateInfo->commandBufferCount);
+
+                for (std::uint32_t i = 0; i < pAllocateInfo->commandBufferCount; ++i)
+                {
+                    record.WriteNewId(VK_OBJECT_TYPE_COMMAND_BUFFER, pCommandBuffers[i]);
+                }
+            }
+
+            return result;
+        }
+
+        VKAPI_ATTR void VKAPI_CALL FreeCommandBuffersHook(VkDevice device, VkCommandPool commandPool, std::uint32_t count, const VkCommandBuffer* pCommandBuffers)
+        {
+            for (std::uint32_t i = 0; i < count; ++i)
+            {
+                if (pCommandBuffers[i] == VK_NULL_HANDLE) { continue; }
+                if (Record record(CaptureOp::Destroy); record) { record.WriteDestroy(VK_OBJECT_TYPE_COMMAND_BUFFER, pCommandBuffers[i]); }
+            }
+
+            Hook<&vkFreeCommandBuffers>::CallOriginal(device, commandPool, count, pCommandBuffers);
+        }
+
+        VKAPI_ATTR VkResult VKAPI_CALL CreateSwapchainHook(VkDevice device, const VkSwapchainCreateInfoKHR* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkSwapchainKHR* pSwapchain)
+        {
+            VkResult result = Hook<&vkCreateSwapchainKHR>::CallOriginal(device, pCreateInfo, pAllocator, pSwapchain);
+            if (result != VK_SUCCESS) { return result; }
+
+            g_Capture->AddSwapchain(ToKey(*pSwapchain), {pCreateInfo->imageFormat, pCreateInfo->imageExtent, pCreateInfo->imageUsage, {}});
+            return result;
+        }
+
+        VKAPI_ATTR void VKAPI_CALL DestroySwapchainHook(VkDevice device, VkSwapchainKHR swapchain, const VkAllocationCallbacks* pAllocator)
+        {
+            if (swapchain != VK_NULL_HANDLE)
+            {
+                for (std::uint64_t image : g_Capture->RemoveSwapchain(ToKey(swapchain)))
+                {
+                    if (Record record(CaptureOp::Destroy); record) { record.WriteDestroy(VK_OBJECT_TYPE_IMAGE, image); }
+                }
+            }
+
+            Hook<&vkDestroySwapchainKHR>::CallOriginal(device, swapchain, pAllocator);
+        }
+
+        VKAPI_ATTR VkResult VKAPI_CALL GetSwapchainImagesHook(VkDevice device, VkSwapchainKHR swapchain, std::uint32_t* pSwapchainImageCount, VkImage* pSwapchainImages)
+        {
+            VkResult result = Hook<&vkGetSwapchainImagesKHR>::CallOriginal(device, swapchain, pSwapchainImageCount, pSwapchainImages);
+            if (pSwapchainImages == nullptr || (result != VK_SUCCESS && result != VK_INCOMPLETE)) { return result; }
+
+            if (Record record; record)
+            {
+                // looked up before the record is opened, so refusing doesn't leave a truncated one behind
+                CommandCapture::Swapchain* captured = record.GetCapture().FindSwapchain(ToKey(swapchain));
+                if (captured == nullptr) { throw std::runtime_error("swapchain was created before the capture"); }
+
+                record.Open(CaptureOp::SwapchainImage);
+                record.Write(captured->format);
+                record.Write(captured->extent);
+                record.Write(captured->usage);
+                record.Write(*pSwapchainImageCount);
+
+                for (std::uint32_t i = 0; i < *pSwapchainImageCount; ++i)
+                {
+                    record.WriteNewId(VK_OBJECT_TYPE_IMAGE, pSwapchainImages[i]);
+                    captured->images.push_back(ToKey(pSwapchainImages[i]));
+                }
+            }
+
+            return result;
+        }
+
+        VKAPI_ATTR VkResult VKAPI_CALL BeginCommandBufferHook(VkCommandBuffer commandBuffer, const VkCommandBufferBeginInfo* pBeginInfo)
+        {
+            VkResult result = Hook<&vkBeginCommandBuffer>::CallOriginal(commandBuffer, pBeginInfo);
+            if (result != VK_SUCCESS) { return result; }
+
+            // only primary command buffers are captured, so the inheritance info is dropped
+            if (Record record(CaptureOp::BeginCommandBuffer); record)
+            {
+                record.WriteId(VK_OBJECT_TYPE_COMMAND_BUFFER, commandBuffer);
+                record.Write(pBeginInfo->flags);
+            }
+
+            return result;
+        }
+
+        VKAPI_ATTR VkResult VKAPI_CALL EndCommandBufferHook(VkCommandBuffer commandBuffer)
+        {
+            VkResult result = Hook<&vkEndCommandBuffer>::CallOriginal(commandBuffer);
+            if (result != VK_SUCCESS) { return result; }
+
+            if (Record record(CaptureOp::EndCommandBuffer); record) { record.WriteId(VK_OBJECT_TYPE_COMMAND_BUFFER, commandBuffer); }
+            return result;
+        }
+
+        VKAPI_ATTR VkResult VKAPI_CALL ResetCommandBufferHook(VkCommandBuffer commandBuffer, VkCommandBufferResetFlags flags)
+        {
+            VkResult result = Hook<&vkResetCommandBuffer>::CallOriginal(commandBuffer, flags);
+            if (result != VK_SUCCESS) { return result; }
+
+            if (Record record(CaptureOp::ResetCommandBuffer); record)
+            {
+                record.WriteId(VK_OBJECT_TYPE_COMMAND_BUFFER, commandBuffer);
+                record.Write(flags);
+            }
+
+            return result;
+        }
+
+        VKAPI_ATTR void VKAPI_CALL CmdBeginRenderPassHook(VkCommandBuffer commandBuffer, const VkRenderPassBeginInfo* pRenderPassBegin, VkSubpassContents contents)
+        {
+            Hook<&vkCmdBeginRenderPass>::CallOriginal(commandBuffer, pRenderPassBegin, contents);
+
+            if (Record record(CaptureOp::BeginRenderPass); record)
+            {
+                record.WriteId(VK_OBJECT_TYPE_COMMAND_BUFFER, commandBuffer);
+                record.WriteId(VK_OBJECT_TYPE_RENDER_PASS, pRenderPassBegin->renderPass);
+                record.WriteId(VK_OBJECT_TYPE_FRAMEBUFFER, pRenderPassBegin->framebuffer);
+                record.Write(pRenderPassBegin->renderArea);
+                record.WriteArray(pRenderPassBegin->pClearValues, pRenderPassBegin->clearValueCount);
+                record.Write(contents);
+            }
+        }
+
+        VKAPI_ATTR void VKAPI_CALL CmdNextSubpassHook(VkCommandBuffer commandBuffer, VkSubpassContents contents)
+        {
+            Hook<&vkCmdNextSubpass>::CallOriginal(commandBuffer, contents);
+
+            if (Record record(CaptureOp::NextSubpass); record)
+            {
+                record.WriteId(VK_OBJECT_TYPE_COMMAND_BUFFER, commandBuffer);
+                record.Write(contents);
+            }
+        }
+
+        VKAPI_ATTR void VKAPI_CALL CmdEndRenderPassHook(VkCommandBuffer commandBuffer)
+        {
+            Hook<&vkCmdEndRenderPass>::CallOriginal(commandBuffer);
+            if (Record record(CaptureOp::EndRenderPass); record) { record.WriteId(VK_OBJECT_TYPE_COMMAND_BUFFER, commandBuffer); }
+        }
+
+        VKAPI_ATTR void VKAPI_CALL CmdBindPipelineHook(VkCommandBuffer commandBuffer, VkPipelineBindPoint pipelineBindPoint, VkPipeline pipeline)
+        {
+            Hook<&vkCmdBindPipeline>::CallOriginal(commandBuffer, pipelineBindPoint, pipeline);
+
+            if (Record record(CaptureOp::BindPipeline); record)
+            {
+                record.WriteId(VK_OBJECT_TYPE_COMMAND_BUFFER, commandBuffer);
+                record.Write(pipelineBindPoint);
+                record.WriteId(VK_OBJECT_TYPE_PIPELINE, pipeline);
+            }
+        }
+
+        VKAPI_ATTR void VKAPI_CALL CmdSetViewportHook(VkCommandBuffer commandBuffer, std::uint32_t firstViewport, std::uint32_t viewportCount, const VkViewport* pViewports)
+        {
+            Hook<&vkCmdSetViewport>::CallOriginal(commandBuffer, firstViewport, viewportCount, pViewports);
+
+            if (Record record(CaptureOp::SetViewport); record)
+            {
+                record.WriteId(VK_OBJECT_TYPE_COMMAND_BUFFER, commandBuffer);
+                record.Write(firstViewport);
+                record.WriteArray(pViewports, viewportCount);
+            }
+        }
+
+        VKAPI_ATTR void VKAPI_CALL CmdSetScissorHook(VkCommandBuffer commandBuffer, std::uint32_t firstScissor, std::uint32_t scissorCount, const VkRect2D* pScissors)
+        {
+            Hook<&vkCmdSetScissor>::CallOriginal(commandBuffer, firstScissor, scissorCount, pScissors);
+
+            if (Record record(CaptureOp::SetScissor); record)
+            {
+                record.WriteId(VK_OBJECT_TYPE_COMMAND_BUFFER, commandBuffer);
+                record.Write(firstScissor);
+                record.WriteArray(pScissors, scissorCount);
+            }
+        }
+
+        VKAPI_ATTR void VKAPI_CALL CmdDrawHook(VkCommandBuffer commandBuffer, std::uint32_t vertexCount, std::uint32_t instanceCount, std::uint32_t firstVertex, std::uint32_t firstInstance)
+        {
+            Hook<&vkCmdDraw>::CallOriginal(commandBuffer, vertexCount, instanceCount, firstVertex, firstInstance);
+
+            if (Record record(CaptureOp::Draw); record)
+            {
+                record.WriteId(VK_OBJECT_TYPE_COMMAND_BUFFER, commandBuffer);
+                record.Write(vertexCount);
+                record.Write(instanceCount);
+                record.Write(firstVertex);
+                record.Write(firstInstance);
+            }
+        }
+
+        VKAPI_ATTR void VKAPI_CALL CmdPipelineBarrierHook(VkCommandBuffer commandBuffer, VkPipelineStageFlags srcStageMask, VkPipelineStageFlags dstStageMask, VkDependencyFlags dependencyFlags,
+            std::uint32_t memoryBarrierCount, const VkMemoryBarrier* pMemoryBarriers, std::uint32_t bufferMemoryBarrierCount, const VkBufferMemoryBarrier* pBufferMemoryBarriers,
+            std::uint32_t imageMemoryBarrierCount, const VkImageMemoryBarrier* pImageMemoryBarriers)
+        {
+            Hook<&vkCmdPipelineBarrier>::CallOriginal(commandBuffer, srcStageMask, dstStageMask, dependencyFlags, memoryBarrierCount, pMemoryBarriers, bufferMemoryBarrierCount, pBufferMemoryBarriers,
+                imageMemoryBarrierCount, pImageMemoryBarriers);
+
+            // buffers aren't captured, so neither are their barriers
+            if (Record record(CaptureOp::PipelineBarrier); record)
+            {
+                record.WriteId(VK_OBJECT_TYPE_COMMAND_BUFFER, commandBuffer);
+                record.Write(srcStageMask);
+                record.Write(dstStageMask);
+                record.Write(dependencyFlags);
+                record.Write(memoryBarrierCount);
+
+                for (std::uint32_t i = 0; i < memoryBarrierCount; ++i)
+                {
+                    record.Write(Strip(pMemoryBarriers[i]));
+                }
+
+                record.Write(imageMemoryBarrierCount);
+
+                for (std::uint32_t i = 0; i < imageMemoryBarrierCount; ++i)
+                {
+                    VkImageMemoryBarrier barrier = Strip(pImageMemoryBarriers[i]);
+                    barrier.image = VK_NULL_HANDLE;
+                    record.WriteId(VK_OBJECT_TYPE_IMAGE, pImageMemoryBarriers[i].image);
+                    record.Write(barrier);
+                }
+            }
+        }
+
+        VKAPI_ATTR void VKAPI_CALL CmdBlitImageHook(VkCommandBuffer commandBuffer, VkImage srcImage, VkImageLayout srcImageLayout, VkImage dstImage, VkImageLayout dstImageLayout,
+            std::uint32_t regionCount, const VkImageBlit* pRegions, VkFilter filter)
+        {
+            Hook<&vkCmdBlitImage>::CallOriginal(commandBuffer, srcImage, srcImageLayout, dstImage, dstImageLayout, regionCount, pRegions, filter);
+
+            if (Record record(CaptureOp::BlitImage); record)
+            {
+                record.WriteId(VK_OBJECT_TYPE_COMMAND_BUFFER, commandBuffer);
+                record.WriteId(VK_OBJECT_TYPE_IMAGE, srcImage);
+                record.Write(srcImageLayout);
+                record.WriteId(VK_OBJECT_TYPE_IMAGE, dstImage);
+                record.Write(dstImageLayout);
+                record.WriteArray(pRegions, regionCount);
+                record.Write(filter);
+            }
+        }
+
+        VKAPI_ATTR VkResult VKAPI_CALL QueueSubmit2Hook(VkQueue queue, std::uint32_t submitCount, const VkSubmitInfo2* pSubmits, VkFence fence)
+        {
+            VkResult result = Hook<&vkQueueSubmit2>::CallOriginal(queue, submitCount, pSubmits, fence);
+            if (result != VK_SUCCESS) { return result; }
+
+            // the replay runs everything on one queue in submission order, so semaphores are dropped
+            if (Record record(CaptureOp::Submit); record)
+            {
+                record.Write(submitCount);
+
+                for (std::uint32_t i = 0; i < submitCount; ++i)
+                {
+                    record.Write(pSubmits[i].commandBufferInfoCount);
+
+                    for (std::uint32_t j = 0; j < pSubmits[i].commandBufferInfoCount; ++j)
+                    {
+                        record.WriteId(VK_OBJECT_TYPE_COMMAND_BUFFER, pSubmits[i].pCommandBufferInfos[j].commandBuffer);
+                    }
+                }
+            }
+
+            return result;
+        }
+
+        VKAPI_ATTR VkResult VKAPI_CALL QueuePresentHook(VkQueue queue, const VkPresentInfoKHR* pPresentInfo)
+        {
+            VkResult result = Hook<&vkQueuePresentKHR>::CallOriginal(queue, pPresentInfo);
+
+            // only marks the end of a frame, the replay doesn't present
+            if (Record record(CaptureOp::Present); record) { record.Write(pPresentInfo->swapchainCount); }
+
+            g_Capture->OnPresent();
+            return result;
+        }
+    }
+
+    CommandCapture::CommandCapture(VkPhysicalDevice physicalDevice, const std::string& path, std::uint32_t frameLimit) :
+    m_File(path, std::ios::binary | std::ios::trunc), m_FrameLimit(frameLimit), m_FrameCount(0), m_Active(true), m_NextId(1)
+    {
+        if (!m_File.is_open())
+        {
+            throw std::runtime_error("couldn't open capture file '" + path + "'");
+        }
+
+        vkGetPhysicalDeviceMemoryProperties(physicalDevice, &m_MemoryProperties);
+        m_Writer.Write(kCaptureMagic);
+        m_Writer.Write(kCaptureVersion);
+    }
+
+    CommandCapture::~CommandCapture() noexcept
+    {
+        Uninstall();
+        Stop();
+    }
+
+    void CommandCapture::Install()
+    {
+        if (g_Capture != nullptr) { throw std::runtime_error("a command capture is already installed"); }
+
+        g_Capture = this;
+        Hook<&vkCreateImage>::Install(&CreateImageHook);
+        Hook<&vkDestroyImage>::Install(&DestroyHook<&vkDestroyImage, VK_OBJECT_TYPE_IMAGE, VkImage>);
+        Hook<&vkAllocateMemory>::Install(&AllocateMemoryHook);
+        Hook<&vkFreeMemory>::Install(&DestroyHook<&vkFreeMemory, VK_OBJECT_TYPE_DEVICE_MEMORY, VkDeviceMemory>);
+        Hook<&vkBindImageMemory>::Install(&BindImageMemoryHook);
+        Hook<&vkCreateImageView>::Install(&CreateImageViewHook);
+        Hook<&vkDestroyImageView>::Install(&DestroyHook<&vkDestroyImageView, VK_OBJECT_TYPE_IMAGE_VIEW, VkImageView>);
+        Hook<&vkCreateShaderModule>::Install(&CreateShaderModuleHook);
+        Hook<&vkDestroyShaderModule>::Install(&DestroyHook<&vkDestroyShaderModule, VK_OBJECT_TYPE_SHADER_MODULE, VkShaderModule>);
+        Hook<&vkCreatePipelineLayout>::Install(&CreatePipelineLayoutHook);
+        Hook<&vkDestroyPipelineLayout>::Install(&DestroyHook<&vkDestroyPipelineLayout, VK_OBJECT_TYPE_PIPELINE_LAYOUT, VkPipelineLayout>);
+        Hook<&vkCreateRenderPass>::Install(&CreateRenderPassHook);
+        Hook<&vkDestroyRenderPass>::Install(&DestroyHook<&vkDestroyRenderPass, VK_OBJECT_TYPE_RENDER_PASS, VkRenderPass>);
+        Hook<&vkCreateFramebuffer>::Install(&CreateFramebufferHook);
+        Hook<&vkDestroyFramebuffer>::Install(&DestroyHook<&vkDestroyFramebuffer, VK_OBJECT_TYPE_FRAMEBUFFER, VkFramebuffer>);
+        Hook<&vkCreateGraphicsPipelines>::Install(&CreateGraphicsPipelinesHook);
+        Hook<&vkDestroyPipeline>::Install(&DestroyHook<&vkDestroyPipeline, VK_OBJECT_TYPE_PIPELINE, VkPipeline>);
+        Hook<&vkCreateCommandPool>::Install(&CreateCommandPoolHook);
+        Hook<&vkDestroyCommandPool>::Install(&DestroyHook<&vkDestroyCommandPool, VK_OBJECT_TYPE_COMMAND_POOL, VkCommandPool>);
+        Hook<&vkAllocateCommandBuffers>::Install(&AllocateCommandBuffersHook);
+        Hook<&vkFreeCommandBuffers>::Install(&FreeCommandBuffersHook);
+        Hook<&vkCreateSwapchainKHR>::Install(&CreateSwapchainHook);
+        Hook<&vkDestroySwapchainKHR>::Install(&DestroySwapchainHook);
+        Hook<&vkGetSwapchainImagesKHR>::Install(&GetSwapchainImagesHook);
+        Hook<&vkBeginCommandBuffer>::Install(&BeginCommandBufferHook);
+        Hook<&vkEndCommandBuffer>::Install(&EndCommandBufferHook);
+        Hook<&vkResetCommandBuffer>::Install(&ResetCommandBufferHook);
+        Hook<&vkCmdBeginRenderPass>::Install(&CmdBeginRenderPassHook);
+        Hook<&vkCmdNextSubpass>::Install(&CmdNextSubpassHook);
+        Hook<&vkCmdEndRenderPass>::Install(&CmdEndRenderPassHook);
+        Hook<&vkCmdBindPipeline>::Install(&CmdBindPipelineHook);
+        Hook<&vkCmdSetViewport>::Install(&CmdSetViewportHook);
+        Hook<&vkCmdSetScissor>::Install(&CmdSetScissorHook);
+        Hook<&vkCmdDraw>::Install(&CmdDrawHook);
+        Hook<&vkCmdPipelineBarrier>::Install(&CmdPipelineBarrierHook);
+        Hook<&vkCmdBlitImage>::Install(&CmdBlitImageHook);
+        Hook<&vkQueueSubmit2>::Install(&QueueSubmit2Hook);
+        Hook<&vkQueuePresentKHR>::Install(&QueuePresentHook);
+    }
+
+    void CommandCapture::Uninstall() noexcept
+    {
+        if (g_Capture != this) { return; }
+
+        Hook<&vkCreateImage>::Uninstall();
+        Hook<&vkDestroyImage>::Uninstall();
+        Hook<&vkAllocateMemory>::Uninstall();
+        Hook<&vkFreeMemory>::Uninstall();
+        Hook<&vkBindImageMemory>::Uninstall();
+        Hook<&vkCreateImageView>::Uninstall();
+        Hook<&vkDestroyImageView>::Uninstall();
+        Hook<&vkCreateShaderModule>::Uninstall();
+        Hook<&vkDestroyShaderModule>::Uninstall();
+        Hook<&vkCreatePipelineLayout>::Uninstall();
+        Hook<&vkDestroyPipelineLayout>::Uninstall();
+        Hook<&vkCreateRenderPass>::Uninstall();
+        Hook<&vkDestroyRenderPass>::Uninstall();
+        Hook<&vkCreateFramebuffer>::Uninstall();
+        Hook<&vkDestroyFramebuffer>::Uninstall();
+        Hook<&vkCreateGraphicsPipelines>::Uninstall();
+        Hook<&vkDestroyPipeline>::Uninstall();
+        Hook<&vkCreateCommandPool>::Uninstall();
+        Hook<&vkDestroyCommandPool>::Uninstall();
+        Hook<&vkAllocateCommandBuffers>::Uninstall();
+        Hook<&vkFreeCommandBuffers>::Uninstall();
+        Hook<&vkCreateSwapchainKHR>::Uninstall();
+        Hook<&vkDestroySwapchainKHR>::Uninstall();
+        Hook<&vkGetSwapchainImagesKHR>::Uninstall();
+        Hook<&vkBeginCommandBuffer>::Uninstall();
+        Hook<&vkEndCommandBuffer>::Uninstall();
+        Hook<&vkResetCommandBuffer>::Uninstall();
+        Hook<&vkCmdBeginRenderPass>::Uninstall();
+        Hook<&vkCmdNextSubpass>::Uninstall();
+        Hook<&vkCmdEndRenderPass>::Uninstall();
+        Hook<&vkCmdBindPipeline>::Uninstall();
+        Hook<&vkCmdSetViewport>::Uninstall();
+        Hook<&vkCmdSetScissor>::Uninstall();
+        Hook<&vkCmdDraw>::Uninstall();
+        Hook<&vkCmdPipelineBarrier>::Uninstall();
+        Hook<&vkCmdBlitImage>::Uninstall();
+        Hook<&vkQueueSubmit2>::Uninstall();
+        Hook<&vkQueuePresentKHR>::Uninstall();
+        g_Capture = nullptr;
+    }
+
+    void CommandCapture::Stop() noexcept
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        Close();
+    }
+
+    void CommandCapture::WriteToFile() noexcept
+    {
+        const auto& data = m_Writer.GetData();
+        m_File.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        m_Writer.Clear();
+
+        if (!m_File)
+        {
+            std::cerr << "Failed to write capture, stopping it.\n";
+            m_Active = false;
+        }
+    }
+
+    void CommandCapture::Close() noexcept
+    {
+        if (!m_Active) { return; }
+
+        WriteToFile();
+        m_File.close();
+        m_Active = false;
+        std::cout << "Captured " << m_FrameCount << " frame(s).\n";
+    }
+
+    bool CommandCapture::Lock()
+    {
+        m_Mutex.lock();
+
+        if (!m_Active)
+        {
+            m_Mutex.unlock();
+            return false;
+        }
+
+        return true;
+    }
+
+    void CommandCapture::Unlock() noexcept
+    {
+        if (m_Writer.GetData().size() >= kFlushSize) { WriteToFile(); }
+        m_Mutex.unlock();
+    }
+
+    bool CommandCapture::IsActive() noexcept
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Active;
+    }
+
+    void CommandCapture::OnPresent() noexcept
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (!m_Active) { return; }
+
+        // stays installed once the frames are in, the hooks just stop recording
+        if (++m_FrameCount == m_FrameLimit) { Close(); }
+    }
+
+    std::uint64_t CommandCapture::AssignId(VkObjectType type, std::uint64_t handle)
+    {
+        std::uint64_t id = m_NextId++;
+        m_Ids[{type, handle}] = id;
+        return id;
+    }
+
+    std::uint64_t CommandCapture::GetId(VkObjectType type, std::uint64_t handle) const noexcept
+    {
+        // also covers VK_NULL_HANDLE, which is never assigned an id
+        auto it = m_Ids.find({type, handle});
+        return it != m_Ids.end() ? it->second : 0;
+    }
+
+    std::uint64_t CommandCapture::ReleaseId(VkObjectType type, std::uint64_t handle) noexcept
+    {
+        auto it = m_Ids.find({type, handle});
+        if (it == m_Ids.end()) { return 0; }
+
+        std::uint64_t id = it->second;
+        m_Ids.erase(it);
+        return id;
+    }
+
+    CommandCapture::Swapchain* CommandCapture::FindSwapchain(std::uint64_t swapchain) noexcept
+    {
+        auto it = m_Swapchains.find(swapchain);
+        return it != m_Swapchains.end() ? &it->second : nullptr;
+    }
+
+    void CommandCapture::AddSwapchain(std::uint64_t swapchain, const Swapchain& info)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Swapchains[swapchain] = info;
+    }
+
+    std::vector<std::uint64_t> CommandCapture::RemoveSwapchain(std::uint64_t swapchain)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        auto it = m_Swapchains.find(swapchain);
+        if (it == m_Swapchains.end()) { return {}; }
+
+        std::vector<std::uint64_t> images = std::move(it->second.images);
+        m_Swapchains.erase(it);
+        return images;
+    }
+}
\ No newline at end of file
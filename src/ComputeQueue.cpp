@@ -0,0 +1,111 @@
+#include "VkTest/ComputeQueue.h"
+
+namespace VkTest
+{
+    namespace
+    {
+        // orders everything before it in submission order on the queue against everything after it
+        void RecordQueueBarrier(VkCommandBuffer commandBuffer, VkPipelineStageFlags srcStage, VkPipelineStageFlags dstStage) noexcept
+        {
+            VkMemoryBarrier barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+            barrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+            vkCmdPipelineBarrier(commandBuffer, srcStage, dstStage, 0, 1, &barrier, 0, NULL, 0, NULL);
+        }
+    }
+
+    ComputeQueue::ComputeQueue(VkDevice device, SubmitScheduler& scheduler, SubmitScheduler::QueueId queueId, std::uint32_t familyIndex) :
+    m_Device(device), m_Scheduler(scheduler), m_QueueId(queueId), m_CommandPool(VK_NULL_HANDLE)
+    {
+        VkCommandPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+        poolInfo.queueFamilyIndex = familyIndex;
+
+        if (vkCreateCommandPool(m_Device, &poolInfo, NULL, &m_CommandPool) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create compute command pool");
+        }
+    }
+
+    ComputeQueue::~ComputeQueue() noexcept
+    {
+        m_Scheduler.Wait(m_QueueId, m_Scheduler.GetSubmittedValue(m_QueueId));
+        vkDestroyCommandPool(m_Device, m_CommandPool, NULL);
+    }
+
+    VkCommandBuffer ComputeQueue::AcquireCommandBuffer()
+    {
+        std::uint64_t completed = m_Scheduler.GetCompletedValue(m_QueueId);
+
+        while (!m_InFlight.empty() && m_InFlight.front().value <= completed)
+        {
+            m_FreeCommandBuffers.push_back(m_InFlight.front().commandBuffer);
+            m_InFlight.pop_front();
+        }
+
+        if (!m_FreeCommandBuffers.empty())
+        {
+            VkCommandBuffer commandBuffer = m_FreeCommandBuffers.back();
+            m_FreeCommandBuffers.pop_back();
+            vkResetCommandBuffer(commandBuffer, 0);
+            return commandBuffer;
+        }
+
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = m_CommandPool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandBufferCount = 1;
+
+        VkCommandBuffer commandBuffer;
+
+        if (vkAllocateCommandBuffers(m_Device, &allocInfo, &commandBuffer) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to allocate compute command buffer");
+        }
+
+        return commandBuffer;
+    }
+
+    std::uint64_t ComputeQueue::Dispatch(const std::function<void(VkCommandBuffer)>& record, const std::vector<TimelineWait>& waits)
+    {
+        VkCommandBuffer commandBuffer = AcquireCommandBuffer();
+
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+        if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to begin recording compute command buffer");
+        }
+
+        // on a queue shared with graphics the scheduler drops waits on its own timeline, so the
+        // dispatch is fenced off from the graphics work around it in the stream itself
+        bool shared = m_Scheduler.IsShared(m_QueueId);
+
+        if (shared) { RecordQueueBarrier(commandBuffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT); }
+
+        record(commandBuffer);
+
+        if (shared) { RecordQueueBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT); }
+
+        if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to record compute command buffer");
+        }
+
+        // signalled by the next flush
+        std::uint64_t signalValue = m_Scheduler.GetPendingValue(m_QueueId);
+
+        SubmitBatch batch(m_Scheduler.GetBatchMemory());
+        batch.commandBuffers.push_back(commandBuffer);
+        batch.waits.assign(waits.begin(), waits.end());
+        m_Scheduler.Enqueue(m_QueueId, std::move(batch));
+
+        m_InFlight.push_back({commandBuffer, signalValue});
+        return signalValue;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#include "VkTest/DeletionQueue.h"
+
+#include <algorithm>
+
+namespace VkTest
+{
+    DeletionQueue::~DeletionQueue() noexcept
+    {
+        Flush();
+    }
+
+    void DeletionQueue::Push(SubmitScheduler::QueueId queueId, std::uint64_t value, std::function<void()> destroy)
+    {
+        m_Entries.push_back({queueId, value, std::move(destroy)});
+    }
+
+    void DeletionQueue::Collect(const SubmitScheduler& scheduler)
+    {
+        if (m_Entries.empty()) { return; }
+
+        // entries for different queues retire independently, but whatever is left keeps its order
+        std::size_t kept = 0;
+
+        // the counter is a driver call, so it's read once per queue rather than once per entry
+        std::fill(m_CompletedValues.begin(), m_CompletedValues.end(), std::nullopt);
+
+        for (std::size_t i = 0; i < m_Entries.size(); ++i)
+        {
+            SubmitScheduler::QueueId queueId = m_Entries[i].queueId;
+            if (queueId >= m_CompletedValues.size()) { m_CompletedValues.resize(queueId + 1); }
+
+            auto& completed = m_CompletedValues[queueId];
+            if (!completed.has_value()) { completed = scheduler.GetCompletedValue(queueId); }
+
+            if (completed.value() >= m_Entries[i].value)
+            {
+                m_Entries[i].destroy();
+            }
+            else
+            {
+                if (kept != i) { m_Entries[kept] = std::move(m_Entries[i]); }
+                ++kept;
+            }
+        }
+
+        m_Entries.erase(m_Entries.begin() + kept, m_Entries.end());
+    }
+
+    void DeletionQueue::Flush() noexcept
+    {
+        // only safe once the device is idle
+        for (auto& entry : m_Entries)
+        {
+            entry.destroy();
+        }
+
+        m_Entries.clear();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,129 @@
+#include "VkTest/DrawList.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace VkTest
+{
+    namespace
+    {
+        // below this a single chunk on the calling thread beats waking the pool
+        constexpr std::size_t kMinChunkSize = 4096;
+        constexpr std::size_t kRadixSize = 256;
+    }
+
+    DrawList::DrawList(float farPlane) noexcept : m_FarPlane(farPlane), m_OpaqueCount(0)
+    {
+    }
+
+    void DrawList::Clear() noexcept
+    {
+        // keeps the capacity, so a steady frame doesn't reallocate
+        m_Draws.clear();
+        m_Entries.clear();
+        m_OpaqueCount = 0;
+    }
+
+    void DrawList::Add(const Draw& draw)
+    {
+        m_Entries.push_back({MakeKey(draw, m_FarPlane), static_cast<std::uint32_t>(m_Draws.size())});
+        m_Draws.push_back(draw);
+
+        if (!draw.transparent) { ++m_OpaqueCount; }
+    }
+
+    std::uint64_t DrawList::MakeKey(const Draw& draw, float farPlane)
+    {
+        // masking would silently sort the draw in with another pipeline's
+        if (draw.pipeline > 0x3FFF) { throw std::runtime_error("draw pipeline index doesn't fit in the sort key"); }
+
+        // clamp lets NaN through and converting that to an integer is undefined, so it sorts as far
+        float normalised = draw.viewDepth / farPlane;
+        normalised = std::isnan(normalised) ? 1.0f : std::clamp(normalised, 0.0f, 1.0f);
+        std::uint64_t depth = static_cast<std::uint64_t>(normalised * 16777215.0f);
+        std::uint64_t pipeline = draw.pipeline;
+        std::uint64_t material = draw.material;
+
+        if (draw.transparent)
+        {
+            return (std::uint64_t(1) << 62) | ((0xFFFFFF - depth) << 38) | (pipeline << 24) | (material << 8);
+        }
+
+        return (pipeline << 48) | (material << 32) | (depth << 8);
+    }
+
+    void DrawList::Sort(ThreadPool& pool)
+    {
+        std::size_t count = m_Entries.size();
+
+        if (count < 2) { return; }
+
+        std::size_t chunkCount = std::clamp<std::size_t>(count / kMinChunkSize, 1, pool.GetThreadCount() + 1);
+        std::size_t chunkSize = (count + chunkCount - 1) / chunkCount;
+        m_Scratch.resize(count);
+        m_Histograms.resize(chunkCount * kRadixSize);
+
+        SortEntry* source = m_Entries.data();
+        SortEntry* destination = m_Scratch.data();
+
+        for (unsigned shift = 0; shift < 64; shift += 8)
+        {
+            std::fill(m_Histograms.begin(), m_Histograms.end(), 0);
+
+            pool.ParallelFor(chunkCount, [&](std::size_t chunk)
+            {
+                std::uint32_t* histogram = &m_Histograms[chunk * kRadixSize];
+                std::size_t end = std::min(count, (chunk + 1) * chunkSize);
+
+                for (std::size_t i = chunk * chunkSize; i < end; ++i)
+                {
+                    ++histogram[(source[i].key >> shift) & 0xFF];
+                }
+            });
+
+            // a byte every key shares wouldn't move anything
+            std::size_t firstDigit = (source[0].key >> shift) & 0xFF;
+            std::size_t firstDigitCount = 0;
+
+            for (std::size_t chunk = 0; chunk < chunkCount; ++chunk)
+            {
+                firstDigitCount += m_Histograms[chunk * kRadixSize + firstDigit];
+            }
+
+            if (firstDigitCount == count) { continue; }
+
+            // offsets go digit by digit and then chunk by chunk, so each chunk writes its own
+            // slots in input order and the sort stays stable
+            std::uint32_t offset = 0;
+
+            for (std::size_t digit = 0; digit < kRadixSize; ++digit)
+            {
+                for (std::size_t chunk = 0; chunk < chunkCount; ++chunk)
+                {
+                    std::uint32_t& slot = m_Histograms[chunk * kRadixSize + digit];
+                    std::uint32_t digitCount = slot;
+                    slot = offset;
+                    offset += digitCount;
+                }
+            }
+
+            pool.ParallelFor(chunkCount, [&](std::size_t chunk)
+            {
+                std::uint32_t* offsets = &m_Histograms[chunk * kRadixSize];
+                std::size_t end = std::min(count, (chunk + 1) * chunkSize);
+
+                for (std::size_t i = chunk * chunkSize; i < end; ++i)
+                {
+                    destination[offsets[(source[i].key >> shift) & 0xFF]++] = source[i];
+                }
+            });
+
+            std::swap(source, destination);
+        }
+
+        if (source != m_Entries.data())
+        {
+            m_Entries.swap(m_Scratch);
+        }
+    }
+}
\ No newline at end of file
@@ -35,7 +35,8 @@ namespace VkTest
         std::to_string(VK_API_VERSION_PATCH(gpu.m_DeviceProperties.apiVersion)) << " variant " <<
         std::to_string(VK_API_VERSION_VARIANT(gpu.m_DeviceProperties.apiVersion)) <<
         "\nhas graphics: " << (gpu.m_GraphicsQueueIndex.has_value() ? "yes" : "no") <<
-        "\ncan present: " << (gpu.m_PresentQueueIndex.has_value() ? "yes" : "no") << '\n';
+        "\ncan present: " << (gpu.m_PresentQueueIndex.has_value() ? "yes" : "no") <<
+        "\ndedicated compute: " << (gpu.HasDedicatedComputeQueue() ? "yes" : "no") << '\n';
         return os;
     }
 }
\ No newline at end of file
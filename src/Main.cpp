@@ -1,21 +1,100 @@
 #include <iostream>
+#include <cstring>
+#include <string>
+#include <charconv>
+#include <cmath>
 
 #include "VkTest/App.h"
 
-int main()
+namespace
 {
+    // the whole argument has to be the number, std::sto* accepts "12abc" and throws on "abc"
+    template<typename T>
+    bool ParseNumber(const char* text, T& value) noexcept
+    {
+        const char* end = text + std::strlen(text);
+        auto [last, error] = std::from_chars(text, end, value);
+        return error == std::errc() && last == end;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    VkTest::AppSettings settings;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--dynamic-resolution") == 0)
+        {
+            settings.dynamicResolution = true;
+
+            if (i + 1 < argc && argv[i + 1][0] != '-')
+            {
+                if (!ParseNumber(argv[++i], settings.targetFrameTime) || !std::isfinite(settings.targetFrameTime) || settings.targetFrameTime <= 0.0f)
+                {
+                    std::cerr << "Invalid target frame time: " << argv[i] << '\n';
+                    return 1;
+                }
+            }
+        }
+        else if (std::strcmp(argv[i], "--windows") == 0 && i + 1 < argc)
+        {
+            if (!ParseNumber(argv[++i], settings.windowCount) || settings.windowCount == 0)
+            {
+                std::cerr << "Invalid window count: " << argv[i] << '\n';
+                return 1;
+            }
+        }
+        else if (std::strcmp(argv[i], "--depth-prepass") == 0)
+        {
+            settings.depthPrepass = true;
+        }
+        else if (std::strcmp(argv[i], "--hot-reload") == 0)
+        {
+            settings.hotReloadShaders = true;
+        }
+        else if (std::strcmp(argv[i], "--stats") == 0)
+        {
+            settings.collectResourceStats = true;
+
+            if (i + 1 < argc && argv[i + 1][0] != '-')
+            {
+                settings.statsPath = argv[++i];
+            }
+        }
+        else if (std::strcmp(argv[i], "--capture") == 0 && i + 1 < argc)
+        {
+            settings.capturePath = argv[++i];
+
+            if (i + 1 < argc && argv[i + 1][0] != '-')
+            {
+                if (!ParseNumber(argv[++i], settings.captureFrames))
+                {
+                    std::cerr << "Invalid capture frame count: " << argv[i] << '\n';
+                    return 1;
+                }
+            }
+        }
+        else
+        {
+            std::cerr << "Unknown option: " << argv[i] << '\n';
+            return 1;
+        }
+    }
+
     std::cout << "Initialising application...\n\n";
 
     try
     {
-        VkTest::App app;
+        VkTest::App app(settings);
+        app.Run();
     }
-    catch (const std::runtime_error& e)
+    catch (const std::exception& e)
     {
         std::cerr << "Error occured: " << e.what() << "\n";
         return 1;
     }
-    
+
     std::cout << "\nExited successfully.\n";
     return 0;
 }
\ No newline at end of file
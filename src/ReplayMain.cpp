@@ -0,0 +1,74 @@
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <optional>
+#include <iterator>
+#include <charconv>
+
+#include "VkTest/Replayer.h"
+
+int main(int argc, char** argv)
+{
+    const char* path = nullptr;
+    std::optional<std::uint32_t> deviceIndex;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--device") == 0 && i + 1 < argc)
+        {
+            std::uint32_t index = 0;
+            const char* text = argv[++i];
+            const char* end = text + std::strlen(text);
+            auto [last, error] = std::from_chars(text, end, index);
+
+            if (error != std::errc() || last != end)
+            {
+                std::cerr << "Invalid device index: " << text << '\n';
+                return 1;
+            }
+
+            deviceIndex = index;
+        }
+        else if (argv[i][0] != '-' && path == nullptr)
+        {
+            path = argv[i];
+        }
+        else
+        {
+            std::cerr << "Unknown option: " << argv[i] << '\n';
+            return 1;
+        }
+    }
+
+    if (path == nullptr)
+    {
+        std::cerr << "Usage: VkTestReplay <capture> [--device index]\n";
+        return 1;
+    }
+
+    std::ifstream file(path, std::ios::binary);
+
+    if (!file.is_open())
+    {
+        std::cerr << "Couldn't open capture " << path << '\n';
+        return 1;
+    }
+
+    std::vector<std::uint8_t> capture((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    try
+    {
+        VkTest::Replayer replayer(deviceIndex);
+        replayer.Replay(capture);
+        replayer.PrintReport(std::cout);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error occured: " << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
\ No newline at end of file
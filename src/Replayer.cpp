@@ -0,0 +1,976 @@
+#include "VkTest/Replayer.h"
+
+#include <iomanip>
+#include <algorithm>
+#include <type_traits>
+
+namespace VkTest
+{
+    namespace
+    {
+        double ElapsedMs(std::chrono::steady_clock::time_point start) noexcept
+        {
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        // only the driver call is timed, not reading the record or building its structs
+        template<typename Call>
+        auto Timed(ReplayTiming& timing, Call&& call)
+        {
+            auto start = std::chrono::steady_clock::now();
+
+            if constexpr (std::is_void_v<decltype(call())>)
+            {
+                call();
+                timing.Add(ElapsedMs(start));
+            }
+            else
+            {
+                auto result = call();
+                timing.Add(ElapsedMs(start));
+                return result;
+            }
+        }
+
+        void Check(VkResult result, CaptureOp op)
+        {
+            if (result != VK_SUCCESS)
+            {
+                throw std::runtime_error(std::string("failed to replay ") + GetCaptureOpName(op));
+            }
+        }
+
+        template<typename Handle>
+        Handle Find(const std::unordered_map<std::uint64_t, Handle>& handles, std::uint64_t id)
+        {
+            if (id == 0) { return Handle{}; }
+
+            auto it = handles.find(id);
+
+            if (it == handles.end())
+            {
+                throw std::runtime_error("capture refers to object " + std::to_string(id) + ", which doesn't exist");
+            }
+
+            return it->second;
+        }
+
+        template<typename Handle>
+        Handle Take(std::unordered_map<std::uint64_t, Handle>& handles, std::uint64_t id)
+        {
+            Handle handle = Find(handles, id);
+            handles.erase(id);
+            return handle;
+        }
+
+        // swapchain images are replayed as plain images, which can't be in the present layout
+        VkImageLayout RemapLayout(VkImageLayout layout) noexcept
+        {
+            return layout == VK_IMAGE_LAYOUT_PRESENT_SRC_KHR ? VK_IMAGE_LAYOUT_GENERAL : layout;
+        }
+
+        template<typename T>
+        const T* ReadState(CaptureReader& record, T& state)
+        {
+            if (record.Read<std::uint8_t>() == 0) { return nullptr; }
+
+            state = record.Read<T>();
+            return &state;
+        }
+    }
+
+    Replayer::Replayer(std::optional<std::uint32_t> deviceIndex) :
+    m_Instance(VK_NULL_HANDLE), m_Device(VK_NULL_HANDLE), m_Queue(VK_NULL_HANDLE), m_Timeline(VK_NULL_HANDLE), m_SubmittedValue(0),
+    m_FrameCount(0), m_SetupMs(0.0), m_FrameWaitMs(0.0)
+    {
+        if (volkInitialize() != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to initialise volk");
+        }
+
+        CreateInstance();
+        CreateDevice(deviceIndex);
+    }
+
+    Replayer::~Replayer() noexcept
+    {
+        if (m_Device != VK_NULL_HANDLE)
+        {
+            vkDeviceWaitIdle(m_Device);
+
+            for (const auto& [id, pipeline] : m_Pipelines) { vkDestroyPipeline(m_Device, pipeline, NULL); }
+            for (const auto& [id, framebuffer] : m_Framebuffers) { vkDestroyFramebuffer(m_Device, framebuffer, NULL); }
+            for (const auto& [id, imageView] : m_ImageViews) { vkDestroyImageView(m_Device, imageView, NULL); }
+            for (const auto& [id, image] : m_Images) { vkDestroyImage(m_Device, image, NULL); }
+            for (const auto& [id, memory] : m_ImageMemory) { vkFreeMemory(m_Device, memory, NULL); }
+
+            for (const auto& [id, memory] : m_Memory)
+            {
+                if (memory.memory != VK_NULL_HANDLE) { vkFreeMemory(m_Device, memory.memory, NULL); }
+            }
+
+            for (const auto& [id, renderPass] : m_RenderPasses) { vkDestroyRenderPass(m_Device, renderPass, NULL); }
+            for (const auto& [id, pipelineLayout] : m_PipelineLayouts) { vkDestroyPipelineLayout(m_Device, pipelineLayout, NULL); }
+            for (const auto& [id, shaderModule] : m_ShaderModules) { vkDestroyShaderModule(m_Device, shaderModule, NULL); }
+
+            // frees the command buffers allocated from them too
+            for (const auto& [id, commandPool] : m_CommandPools) { vkDestroyCommandPool(m_Device, commandPool, NULL); }
+
+            vkDestroySemaphore(m_Device, m_Timeline, NULL);
+            vkDestroyDevice(m_Device, NULL);
+        }
+
+        if (m_Instance != VK_NULL_HANDLE)
+        {
+            vkDestroyInstance(m_Instance, NULL);
+        }
+    }
+
+    void Replayer::CreateInstance()
+    {
+        VkApplicationInfo appInfo{};
+        appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+        appInfo.pApplicationName = "Vulkan Test Replay";
+        appInfo.applicationVersion = VK_MAKE_API_VERSION(0, 1, 0, 0);
+        appInfo.pEngineName = "No Engine";
+        appInfo.engineVersion = VK_MAKE_API_VERSION(0, 1, 0, 0);
+        appInfo.apiVersion = VK_API_VERSION_1_3;
+
+        // nothing is presented, so no surface extensions
+        VkInstanceCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+        createInfo.pApplicationInfo = &appInfo;
+
+        if (vkCreateInstance(&createInfo, NULL, &m_Instance) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create instance");
+        }
+
+        volkLoadInstance(m_Instance);
+    }
+
+    void Replayer::CreateDevice(std::optional<std::uint32_t> deviceIndex)
+    {
+        std::uint32_t deviceCount = 0;
+        vkEnumeratePhysicalDevices(m_Instance, &deviceCount, NULL);
+        std::vector<VkPhysicalDevice> physicalDevices(deviceCount);
+        vkEnumeratePhysicalDevices(m_Instance, &deviceCount, physicalDevices.data());
+
+        std::vector<GPU> gpus;
+
+        for (auto physicalDevice : physicalDevices)
+        {
+            gpus.emplace_back(physicalDevice, std::vector<VkSurfaceKHR>{});
+        }
+
+        // the replay submits with vkQueueSubmit2 and paces itself on a timeline semaphore
+        auto canReplay = [](const GPU& gpu) { return gpu.HasGraphicsQueue() && gpu.HasTimelineSemaphore() && gpu.HasSynchronization2(); };
+
+        if (deviceIndex.has_value())
+        {
+            if (deviceIndex.value() >= gpus.size() || !canReplay(gpus[deviceIndex.value()]))
+            {
+                throw std::runtime_error("device " + std::to_string(deviceIndex.value()) + " can't replay captures");
+            }
+
+            m_GPU = gpus[deviceIndex.value()];
+        }
+        else
+        {
+            auto it = std::find_if(gpus.begin(), gpus.end(), [&](const GPU& gpu) { return canReplay(gpu) && gpu.IsDiscrete(); });
+            if (it == gpus.end()) { it = std::find_if(gpus.begin(), gpus.end(), canReplay); }
+            if (it == gpus.end()) { throw std::runtime_error("no device can replay captures, they need a graphics queue, timeline semaphores and synchronization2"); }
+
+            m_GPU = *it;
+        }
+
+        float priority = 1.0f;
+        VkDeviceQueueCreateInfo queueCreateInfo{};
+        queueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+        queueCreateInfo.queueFamilyIndex = m_GPU->GetGraphicsQueueIndex();
+        queueCreateInfo.queueCount = 1;
+        queueCreateInfo.pQueuePriorities = &priority;
+
+        VkPhysicalDeviceFeatures deviceFeatures{};
+        VkPhysicalDeviceVulkan12Features vulkan12Features{};
+        vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+        vulkan12Features.timelineSemaphore = VK_TRUE;
+        VkPhysicalDeviceVulkan13Features vulkan13Features{};
+        vulkan13Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+        vulkan13Features.synchronization2 = VK_TRUE;
+        vulkan12Features.pNext = &vulkan13Features;
+
+        VkDeviceCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+        createInfo.pNext = &vulkan12Features;
+        createInfo.pQueueCreateInfos = &queueCreateInfo;
+        createInfo.queueCreateInfoCount = 1;
+        createInfo.pEnabledFeatures = &deviceFeatures;
+
+        if (vkCreateDevice(m_GPU->GetPhysicalDevice(), &createInfo, NULL, &m_Device) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create logical device");
+        }
+
+        // straight to the driver, without the loader's dispatch in between
+        volkLoadDevice(m_Device);
+        vkGetDeviceQueue(m_Device, m_GPU->GetGraphicsQueueIndex(), 0, &m_Queue);
+
+        VkSemaphoreTypeCreateInfo timelineCreateInfo{};
+        timelineCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+        timelineCreateInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+        timelineCreateInfo.initialValue = 0;
+
+        VkSemaphoreCreateInfo semaphoreCreateInfo{};
+        semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        semaphoreCreateInfo.pNext = &timelineCreateInfo;
+
+        if (vkCreateSemaphore(m_Device, &semaphoreCreateInfo, NULL, &m_Timeline) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create replay timeline semaphore");
+        }
+    }
+
+    void Replayer::Replay(const std::vector<std::uint8_t>& capture)
+    {
+        CaptureReader reader(capture.data(), capture.size());
+
+        if (reader.Read<std::uint32_t>() != kCaptureMagic)
+        {
+            throw std::runtime_error("not a VkTest capture");
+        }
+
+        std::uint32_t version = reader.Read<std::uint32_t>();
+
+        if (version != kCaptureVersion)
+        {
+            throw std::runtime_error("capture version " + std::to_string(version) + " isn't supported");
+        }
+
+        m_FrameStart = Clock::now();
+
+        while (!reader.IsAtEnd())
+        {
+            CaptureOp op;
+            CaptureReader record = reader.ReadRecord(op);
+            Execute(op, record);
+        }
+
+        Wait(m_SubmittedValue);
+    }
+
+    void Replayer::Execute(CaptureOp op, CaptureReader& record)
+    {
+        ReplayTiming& timing = m_Timings[static_cast<std::size_t>(op)];
+
+        switch (op)
+        {
+        case CaptureOp::CreateImage:
+        {
+            std::uint64_t id = record.Read<std::uint64_t>();
+            VkImageCreateInfo info = record.Read<VkImageCreateInfo>();
+            VkImage image;
+            Check(Timed(timing, [&]() { return vkCreateImage(m_Device, &info, NULL, &image); }), op);
+            m_Images[id] = image;
+            break;
+        }
+        case CaptureOp::SwapchainImage:
+        {
+            VkImageCreateInfo info{};
+            info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+            info.imageType = VK_IMAGE_TYPE_2D;
+            info.format = record.Read<VkFormat>();
+            VkExtent2D extent = record.Read<VkExtent2D>();
+            info.extent = {extent.width, extent.height, 1};
+            info.usage = record.Read<VkImageUsageFlags>();
+            info.mipLevels = 1;
+            info.arrayLayers = 1;
+            info.samples = VK_SAMPLE_COUNT_1_BIT;
+            info.tiling = VK_IMAGE_TILING_OPTIMAL;
+            info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+            info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+            std::uint32_t count = record.ReadCount(sizeof(std::uint64_t));
+
+            for (std::uint32_t i = 0; i < count; ++i)
+            {
+                std::uint64_t id = record.Read<std::uint64_t>();
+                VkImage image;
+                Check(Timed(timing, [&]() { return vkCreateImage(m_Device, &info, NULL, &image); }), op);
+                m_Images[id] = image;
+
+                VkMemoryRequirements memoryRequirements;
+                vkGetImageMemoryRequirements(m_Device, image, &memoryRequirements);
+                VkDeviceMemory memory = AllocateMemory(memoryRequirements.size, memoryRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+                m_ImageMemory[id] = memory;
+                Check(vkBindImageMemory(m_Device, image, memory, 0), op);
+            }
+
+            break;
+        }
+        case CaptureOp::AllocateMemory:
+        {
+            // allocated once an image is bound to it, the memory type has to suit the image on this device
+            std::uint64_t id = record.Read<std::uint64_t>();
+            VkDeviceSize size = record.Read<VkDeviceSize>();
+            m_Memory[id] = {size, record.Read<VkMemoryPropertyFlags>(), VK_NULL_HANDLE};
+            break;
+        }
+        case CaptureOp::BindImageMemory:
+        {
+            VkImage image = Find(m_Images, record.Read<std::uint64_t>());
+            std::uint64_t memoryId = record.Read<std::uint64_t>();
+            VkDeviceSize offset = record.Read<VkDeviceSize>();
+            auto it = m_Memory.find(memoryId);
+
+            if (it == m_Memory.end())
+            {
+                throw std::runtime_error("capture binds memory that was never allocated");
+            }
+
+            VkMemoryRequirements memoryRequirements;
+            vkGetImageMemoryRequirements(m_Device, image, &memoryRequirements);
+            Memory& memory = it->second;
+
+            if (memory.memory == VK_NULL_HANDLE)
+            {
+                memory.size = std::max(memory.size, offset + memoryRequirements.size);
+                memory.memory = AllocateMemory(memory.size, memoryRequirements.memoryTypeBits, memory.properties);
+            }
+            else if (offset + memoryRequirements.size > memory.size)
+            {
+                throw std::runtime_error("replayed image doesn't fit in its captured allocation");
+            }
+
+            Check(Timed(timing, [&]() { return vkBindImageMemory(m_Device, image, memory.memory, offset); }), op);
+            break;
+        }
+        case CaptureOp::CreateImageView:
+        {
+            std::uint64_t id = record.Read<std::uint64_t>();
+            VkImage image = Find(m_Images, record.Read<std::uint64_t>());
+            VkImageViewCreateInfo info = record.Read<VkImageViewCreateInfo>();
+            info.image = image;
+            VkImageView imageView;
+            Check(Timed(timing, [&]() { return vkCreateImageView(m_Device, &info, NULL, &imageView); }), op);
+            m_ImageViews[id] = imageView;
+            break;
+        }
+        case CaptureOp::CreateShaderModule:
+        {
+            std::uint64_t id = record.Read<std::uint64_t>();
+            VkShaderModuleCreateInfo info{};
+            info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+            info.flags = record.Read<VkShaderModuleCreateFlags>();
+            std::vector<std::uint32_t> code = record.ReadArray<std::uint32_t>();
+            info.codeSize = code.size() * sizeof(std::uint32_t);
+            info.pCode = code.data();
+            VkShaderModule shaderModule;
+            Check(Timed(timing, [&]() { return vkCreateShaderModule(m_Device, &info, NULL, &shaderModule); }), op);
+            m_ShaderModules[id] = shaderModule;
+            break;
+        }
+        case CaptureOp::CreatePipelineLayout:
+        {
+            std::uint64_t id = record.Read<std::uint64_t>();
+            VkPipelineLayoutCreateInfo info{};
+            info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+            info.flags = record.Read<VkPipelineLayoutCreateFlags>();
+            std::vector<VkPushConstantRange> ranges = record.ReadArray<VkPushConstantRange>();
+            info.pushConstantRangeCount = static_cast<std::uint32_t>(ranges.size());
+            info.pPushConstantRanges = ranges.data();
+            VkPipelineLayout pipelineLayout;
+            Check(Timed(timing, [&]() { return vkCreatePipelineLayout(m_Device, &info, NULL, &pipelineLayout); }), op);
+            m_PipelineLayouts[id] = pipelineLayout;
+            break;
+        }
+        case CaptureOp::CreateRenderPass:
+            CreateRenderPass(record);
+            break;
+        case CaptureOp::CreateFramebuffer:
+        {
+            std::uint64_t id = record.Read<std::uint64_t>();
+            VkFramebufferCreateInfo info{};
+            info.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+            info.flags = record.Read<VkFramebufferCreateFlags>();
+            info.renderPass = Find(m_RenderPasses, record.Read<std::uint64_t>());
+            std::vector<VkImageView> attachments(record.ReadCount(sizeof(std::uint64_t)));
+
+            for (auto& attachment : attachments)
+            {
+                attachment = Find(m_ImageViews, record.Read<std::uint64_t>());
+            }
+
+            info.attachmentCount = static_cast<std::uint32_t>(attachments.size());
+            info.pAttachments = attachments.data();
+            info.width = record.Read<std::uint32_t>();
+            info.height = record.Read<std::uint32_t>();
+            info.layers = record.Read<std::uint32_t>();
+            VkFramebuffer framebuffer;
+            Check(Timed(timing, [&]() { return vkCreateFramebuffer(m_Device, &info, NULL, &framebuffer); }), op);
+            m_Framebuffers[id] = framebuffer;
+            break;
+        }
+        case CaptureOp::CreateGraphicsPipeline:
+            CreateGraphicsPipeline(record);
+            break;
+        case CaptureOp::CreateCommandPool:
+        {
+            std::uint64_t id = record.Read<std::uint64_t>();
+            VkCommandPoolCreateInfo info{};
+            info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+            info.flags = record.Read<VkCommandPoolCreateFlags>();
+            info.queueFamilyIndex = m_GPU->GetGraphicsQueueIndex();
+            VkCommandPool commandPool;
+            Check(Timed(timing, [&]() { return vkCreateCommandPool(m_Device, &info, NULL, &commandPool); }), op);
+            m_CommandPools[id] = commandPool;
+            break;
+        }
+        case CaptureOp::AllocateCommandBuffer:
+        {
+            std::uint64_t poolId = record.Read<std::uint64_t>();
+            VkCommandBufferAllocateInfo info{};
+            info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            info.commandPool = Find(m_CommandPools, poolId);
+            info.level = record.Read<VkCommandBufferLevel>();
+            info.commandBufferCount = record.ReadCount(sizeof(std::uint64_t));
+            std::vector<VkCommandBuffer> commandBuffers(info.commandBufferCount);
+            Check(Timed(timing, [&]() { return vkAllocateCommandBuffers(m_Device, &info, commandBuffers.data()); }), op);
+
+            for (auto commandBuffer : commandBuffers)
+            {
+                m_CommandBuffers[record.Read<std::uint64_t>()] = {commandBuffer, poolId, 0};
+            }
+
+            break;
+        }
+        case CaptureOp::Destroy:
+        {
+            VkObjectType type = record.Read<VkObjectType>();
+            Destroy(type, record.Read<std::uint64_t>());
+            break;
+        }
+        case CaptureOp::BeginCommandBuffer:
+        {
+            CommandBuffer& commandBuffer = GetCommandBuffer(record.Read<std::uint64_t>());
+            VkCommandBufferBeginInfo info{};
+            info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            info.flags = record.Read<VkCommandBufferUsageFlags>();
+            Wait(commandBuffer.submittedValue);
+            Check(Timed(timing, [&]() { return vkBeginCommandBuffer(commandBuffer.handle, &info); }), op);
+            break;
+        }
+        case CaptureOp::EndCommandBuffer:
+        {
+            VkCommandBuffer commandBuffer = GetCommandBuffer(record.Read<std::uint64_t>()).handle;
+            Check(Timed(timing, [&]() { return vkEndCommandBuffer(commandBuffer); }), op);
+            break;
+        }
+        case CaptureOp::ResetCommandBuffer:
+        {
+            CommandBuffer& commandBuffer = GetCommandBuffer(record.Read<std::uint64_t>());
+            VkCommandBufferResetFlags flags = record.Read<VkCommandBufferResetFlags>();
+            Wait(commandBuffer.submittedValue);
+            Check(Timed(timing, [&]() { return vkResetCommandBuffer(commandBuffer.handle, flags); }), op);
+            break;
+        }
+        case CaptureOp::BeginRenderPass:
+        {
+            VkCommandBuffer commandBuffer = GetCommandBuffer(record.Read<std::uint64_t>()).handle;
+            VkRenderPassBeginInfo info{};
+            info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+            info.renderPass = Find(m_RenderPasses, record.Read<std::uint64_t>());
+            info.framebuffer = Find(m_Framebuffers, record.Read<std::uint64_t>());
+            info.renderArea = record.Read<VkRect2D>();
+            std::vector<VkClearValue> clearValues = record.ReadArray<VkClearValue>();
+            info.clearValueCount = static_cast<std::uint32_t>(clearValues.size());
+            info.pClearValues = clearValues.data();
+            VkSubpassContents contents = record.Read<VkSubpassContents>();
+            Timed(timing, [&]() { vkCmdBeginRenderPass(commandBuffer, &info, contents); });
+            break;
+        }
+        case CaptureOp::NextSubpass:
+        {
+            VkCommandBuffer commandBuffer = GetCommandBuffer(record.Read<std::uint64_t>()).handle;
+            VkSubpassContents contents = record.Read<VkSubpassContents>();
+            Timed(timing, [&]() { vkCmdNextSubpass(commandBuffer, contents); });
+            break;
+        }
+        case CaptureOp::EndRenderPass:
+        {
+            VkCommandBuffer commandBuffer = GetCommandBuffer(record.Read<std::uint64_t>()).handle;
+            Timed(timing, [&]() { vkCmdEndRenderPass(commandBuffer); });
+            break;
+        }
+        case CaptureOp::BindPipeline:
+        {
+            VkCommandBuffer commandBuffer = GetCommandBuffer(record.Read<std::uint64_t>()).handle;
+            VkPipelineBindPoint bindPoint = record.Read<VkPipelineBindPoint>();
+            VkPipeline pipeline = Find(m_Pipelines, record.Read<std::uint64_t>());
+            Timed(timing, [&]() { vkCmdBindPipeline(commandBuffer, bindPoint, pipeline); });
+            break;
+        }
+        case CaptureOp::SetViewport:
+        {
+            VkCommandBuffer commandBuffer = GetCommandBuffer(record.Read<std::uint64_t>()).handle;
+            std::uint32_t first = record.Read<std::uint32_t>();
+            std::vector<VkViewport> viewports = record.ReadArray<VkViewport>();
+            Timed(timing, [&]() { vkCmdSetViewport(commandBuffer, first, static_cast<std::uint32_t>(viewports.size()), viewports.data()); });
+            break;
+        }
+        case CaptureOp::SetScissor:
+        {
+            VkCommandBuffer commandBuffer = GetCommandBuffer(record.Read<std::uint64_t>()).handle;
+            std::uint32_t first = record.Read<std::uint32_t>();
+            std::vector<VkRect2D> scissors = record.ReadArray<VkRect2D>();
+            Timed(timing, [&]() { vkCmdSetScissor(commandBuffer, first, static_cast<std::uint32_t>(scissors.size()), scissors.data()); });
+            break;
+        }
+        case CaptureOp::Draw:
+        {
+            VkCommandBuffer commandBuffer = GetCommandBuffer(record.Read<std::uint64_t>()).handle;
+            std::uint32_t vertexCount = record.Read<std::uint32_t>();
+            std::uint32_t instanceCount = record.Read<std::uint32_t>();
+            std::uint32_t firstVertex = record.Read<std::uint32_t>();
+            std::uint32_t firstInstance = record.Read<std::uint32_t>();
+            Timed(timing, [&]() { vkCmdDraw(commandBuffer, vertexCount, instanceCount, firstVertex, firstInstance); });
+            break;
+        }
+        case CaptureOp::PipelineBarrier:
+        {
+            VkCommandBuffer commandBuffer = GetCommandBuffer(record.Read<std::uint64_t>()).handle;
+            VkPipelineStageFlags srcStageMask = record.Read<VkPipelineStageFlags>();
+            VkPipelineStageFlags dstStageMask = record.Read<VkPipelineStageFlags>();
+            VkDependencyFlags dependencyFlags = record.Read<VkDependencyFlags>();
+            std::vector<VkMemoryBarrier> memoryBarriers(record.ReadCount(sizeof(VkMemoryBarrier)));
+
+            for (auto& barrier : memoryBarriers)
+            {
+                barrier = record.Read<VkMemoryBarrier>();
+            }
+
+            std::vector<VkImageMemoryBarrier> imageBarriers(record.ReadCount(sizeof(std::uint64_t) + sizeof(VkImageMemoryBarrier)));
+
+            // there's only the one queue, so ownership transfers become plain transitions
+            for (auto& barrier : imageBarriers)
+            {
+                VkImage image = Find(m_Images, record.Read<std::uint64_t>());
+                barrier = record.Read<VkImageMemoryBarrier>();
+                barrier.image = image;
+                barrier.oldLayout = RemapLayout(barrier.oldLayout);
+                barrier.newLayout = RemapLayout(barrier.newLayout);
+                barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            }
+
+            Timed(timing, [&]()
+            {
+                vkCmdPipelineBarrier(commandBuffer, srcStageMask, dstStageMask, dependencyFlags, static_cast<std::uint32_t>(memoryBarriers.size()), memoryBarriers.data(), 0, nullptr,
+                    static_cast<std::uint32_t>(imageBarriers.size()), imageBarriers.data());
+            });
+
+            break;
+        }
+        case CaptureOp::BlitImage:
+        {
+            VkCommandBuffer commandBuffer = GetCommandBuffer(record.Read<std::uint64_t>()).handle;
+            VkImage srcImage = Find(m_Images, record.Read<std::uint64_t>());
+            VkImageLayout srcLayout = RemapLayout(record.Read<VkImageLayout>());
+            VkImage dstImage = Find(m_Images, record.Read<std::uint64_t>());
+            VkImageLayout dstLayout = RemapLayout(record.Read<VkImageLayout>());
+            std::vector<VkImageBlit> regions = record.ReadArray<VkImageBlit>();
+            VkFilter filter = record.Read<VkFilter>();
+            Timed(timing, [&]() { vkCmdBlitImage(commandBuffer, srcImage, srcLayout, dstImage, dstLayout, static_cast<std::uint32_t>(regions.size()), regions.data(), filter); });
+            break;
+        }
+        case CaptureOp::Submit:
+        {
+            // every submit starts with its command buffer count
+            std::uint32_t submitCount = record.ReadCount(sizeof(std::uint32_t));
+            if (submitCount == 0) { break; }
+
+            std::vector<std::vector<VkCommandBufferSubmitInfo>> commandBufferInfos(submitCount);
+            std::vector<VkSubmitInfo2> submitInfos(submitCount);
+            std::uint64_t signalValue = m_SubmittedValue + 1;
+
+            for (std::uint32_t i = 0; i < submitCount; ++i)
+            {
+                commandBufferInfos[i].resize(record.ReadCount(sizeof(std::uint64_t)));
+
+                for (auto& info : commandBufferInfos[i])
+                {
+                    CommandBuffer& commandBuffer = GetCommandBuffer(record.Read<std::uint64_t>());
+                    commandBuffer.submittedValue = signalValue;
+                    info = {};
+                    info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO;
+                    info.commandBuffer = commandBuffer.handle;
+                }
+
+                submitInfos[i] = {};
+                submitInfos[i].sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
+                submitInfos[i].commandBufferInfoCount = static_cast<std::uint32_t>(commandBufferInfos[i].size());
+                submitInfos[i].pCommandBufferInfos = commandBufferInfos[i].data();
+            }
+
+            // the captured semaphores are gone, submission order on the one queue stands in for them
+            VkSemaphoreSubmitInfo signal{};
+            signal.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+            signal.semaphore = m_Timeline;
+            signal.value = signalValue;
+            signal.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+            submitInfos.back().signalSemaphoreInfoCount = 1;
+            submitInfos.back().pSignalSemaphoreInfos = &signal;
+
+            Check(Timed(timing, [&]() { return vkQueueSubmit2(m_Queue, submitCount, submitInfos.data(), VK_NULL_HANDLE); }), op);
+            m_SubmittedValue = signalValue;
+            break;
+        }
+        case CaptureOp::Present:
+            record.Read<std::uint32_t>();
+            EndFrame();
+            break;
+        default:
+            throw std::runtime_error("capture contains an unknown op");
+        }
+    }
+
+    void Replayer::CreateRenderPass(CaptureReader& record)
+    {
+        struct Subpass
+        {
+            std::vector<VkAttachmentReference> inputs;
+            std::vector<VkAttachmentReference> colors;
+            std::vector<VkAttachmentReference> resolves;
+            std::vector<VkAttachmentReference> depthStencil;
+            std::vector<std::uint32_t> preserve;
+        };
+
+        std::uint64_t id = record.Read<std::uint64_t>();
+        VkRenderPassCreateInfo info{};
+        info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+        info.flags = record.Read<VkRenderPassCreateFlags>();
+
+        std::vector<VkAttachmentDescription> attachments = record.ReadArray<VkAttachmentDescription>();
+
+        for (auto& attachment : attachments)
+        {
+            attachment.initialLayout = RemapLayout(attachment.initialLayout);
+            attachment.finalLayout = RemapLayout(attachment.finalLayout);
+        }
+
+        // at least the flags, the bind point and five empty arrays each
+        std::uint32_t subpassCount = record.ReadCount(sizeof(VkSubpassDescriptionFlags) + sizeof(VkPipelineBindPoint) + 5 * sizeof(std::uint32_t));
+        std::vector<Subpass> references(subpassCount);
+        std::vector<VkSubpassDescription> subpasses(subpassCount);
+
+        for (std::uint32_t i = 0; i < subpassCount; ++i)
+        {
+            Subpass& refs = references[i];
+            VkSubpassDescription& subpass = subpasses[i];
+            subpass = {};
+            subpass.flags = record.Read<VkSubpassDescriptionFlags>();
+            subpass.pipelineBindPoint = record.Read<VkPipelineBindPoint>();
+            refs.inputs = record.ReadArray<VkAttachmentReference>();
+            refs.colors = record.ReadArray<VkAttachmentReference>();
+            refs.resolves = record.ReadArray<VkAttachmentReference>();
+            refs.depthStencil = record.ReadArray<VkAttachmentReference>();
+            refs.preserve = record.ReadArray<std::uint32_t>();
+
+            subpass.inputAttachmentCount = static_cast<std::uint32_t>(refs.inputs.size());
+            subpass.pInputAttachments = refs.inputs.data();
+            subpass.colorAttachmentCount = static_cast<std::uint32_t>(refs.colors.size());
+            subpass.pColorAttachments = refs.colors.data();
+            subpass.pResolveAttachments = refs.resolves.empty() ? nullptr : refs.resolves.data();
+            subpass.pDepthStencilAttachment = refs.depthStencil.empty() ? nullptr : refs.depthStencil.data();
+            subpass.preserveAttachmentCount = static_cast<std::uint32_t>(refs.preserve.size());
+            subpass.pPreserveAttachments = refs.preserve.data();
+        }
+
+        std::vector<VkSubpassDependency> dependencies = record.ReadArray<VkSubpassDependency>();
+
+        info.attachmentCount = static_cast<std::uint32_t>(attachments.size());
+        info.pAttachments = attachments.data();
+        info.subpassCount = subpassCount;
+        info.pSubpasses = subpasses.data();
+        info.dependencyCount = static_cast<std::uint32_t>(dependencies.size());
+        info.pDependencies = dependencies.data();
+
+        VkRenderPass renderPass;
+        Check(Timed(m_Timings[static_cast<std::size_t>(CaptureOp::CreateRenderPass)], [&]() { return vkCreateRenderPass(m_Device, &info, NULL, &renderPass); }), CaptureOp::CreateRenderPass);
+        m_RenderPasses[id] = renderPass;
+    }
+
+    void Replayer::CreateGraphicsPipeline(CaptureReader& record)
+    {
+        std::uint64_t id = record.Read<std::uint64_t>();
+        VkGraphicsPipelineCreateInfo info{};
+        info.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        info.flags = record.Read<VkPipelineCreateFlags>();
+
+        // sized up front so the entry point strings don't move
+        std::uint32_t stageCount = record.ReadCount(sizeof(VkPipelineShaderStageCreateFlags) + sizeof(VkShaderStageFlagBits) + sizeof(std::uint64_t) + sizeof(std::uint32_t));
+        std::vector<std::string> entryPoints(stageCount);
+        std::vector<VkPipelineShaderStageCreateInfo> stages(stageCount);
+
+        for (std::uint32_t i = 0; i < stageCount; ++i)
+        {
+            stages[i] = {};
+            stages[i].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+            stages[i].flags = record.Read<VkPipelineShaderStageCreateFlags>();
+            stages[i].stage = record.Read<VkShaderStageFlagBits>();
+            stages[i].module = Find(m_ShaderModules, record.Read<std::uint64_t>());
+            entryPoints[i] = record.ReadString();
+            stages[i].pName = entryPoints[i].c_str();
+        }
+
+        info.stageCount = stageCount;
+        info.pStages = stages.data();
+
+        std::vector<VkVertexInputBindingDescription> bindings = record.ReadArray<VkVertexInputBindingDescription>();
+        std::vector<VkVertexInputAttributeDescription> attributes = record.ReadArray<VkVertexInputAttributeDescription>();
+        VkPipelineVertexInputStateCreateInfo vertexInput{};
+        vertexInput.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+        vertexInput.vertexBindingDescriptionCount = static_cast<std::uint32_t>(bindings.size());
+        vertexInput.pVertexBindingDescriptions = bindings.data();
+        vertexInput.vertexAttributeDescriptionCount = static_cast<std::uint32_t>(attributes.size());
+        vertexInput.pVertexAttributeDescriptions = attributes.data();
+        info.pVertexInputState = &vertexInput;
+
+        VkPipelineInputAssemblyStateCreateInfo inputAssembly;
+        info.pInputAssemblyState = ReadState(record, inputAssembly);
+
+        VkPipelineViewportStateCreateInfo viewportState{};
+        std::vector<VkViewport> viewports;
+        std::vector<VkRect2D> scissors;
+
+        if (record.Read<std::uint8_t>() != 0)
+        {
+            viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+            viewportState.viewportCount = record.Read<std::uint32_t>();
+            viewportState.scissorCount = record.Read<std::uint32_t>();
+            viewports = record.ReadArray<VkViewport>();
+            scissors = record.ReadArray<VkRect2D>();
+
+            if ((!viewports.empty() && viewports.size() != viewportState.viewportCount) || (!scissors.empty() && scissors.size() != viewportState.scissorCount))
+            {
+                throw std::runtime_error("capture has a viewport state that doesn't match its counts");
+            }
+
+            // empty when they're dynamic
+            viewportState.pViewports = viewports.empty() ? nullptr : viewports.data();
+            viewportState.pScissors = scissors.empty() ? nullptr : scissors.data();
+            info.pViewportState = &viewportState;
+        }
+
+        VkPipelineRasterizationStateCreateInfo rasterization;
+        info.pRasterizationState = ReadState(record, rasterization);
+        VkPipelineMultisampleStateCreateInfo multisample;
+        info.pMultisampleState = ReadState(record, multisample);
+        VkPipelineDepthStencilStateCreateInfo depthStencil;
+        info.pDepthStencilState = ReadState(record, depthStencil);
+
+        VkPipelineColorBlendStateCreateInfo colorBlend;
+        std::vector<VkPipelineColorBlendAttachmentState> blendAttachments;
+
+        if (record.Read<std::uint8_t>() != 0)
+        {
+            colorBlend = record.Read<VkPipelineColorBlendStateCreateInfo>();
+            blendAttachments = record.ReadArray<VkPipelineColorBlendAttachmentState>();
+            colorBlend.attachmentCount = static_cast<std::uint32_t>(blendAttachments.size());
+            colorBlend.pAttachments = blendAttachments.empty() ? nullptr : blendAttachments.data();
+            info.pColorBlendState = &colorBlend;
+        }
+
+        std::vector<VkDynamicState> dynamicStates = record.ReadArray<VkDynamicState>();
+        VkPipelineDynamicStateCreateInfo dynamicState{};
+
+        if (!dynamicStates.empty())
+        {
+            dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+            dynamicState.dynamicStateCount = static_cast<std::uint32_t>(dynamicStates.size());
+            dynamicState.pDynamicStates = dynamicStates.data();
+            info.pDynamicState = &dynamicState;
+        }
+
+        info.layout = Find(m_PipelineLayouts, record.Read<std::uint64_t>());
+        info.renderPass = Find(m_RenderPasses, record.Read<std::uint64_t>());
+        info.subpass = record.Read<std::uint32_t>();
+
+        VkPipeline pipeline;
+        Check(Timed(m_Timings[static_cast<std::size_t>(CaptureOp::CreateGraphicsPipeline)], [&]() { return vkCreateGraphicsPipelines(m_Device, VK_NULL_HANDLE, 1, &info, NULL, &pipeline); }),
+            CaptureOp::CreateGraphicsPipeline);
+        m_Pipelines[id] = pipeline;
+    }
+
+    void Replayer::Destroy(VkObjectType type, std::uint64_t id)
+    {
+        // objects created before the capture started have no id
+        if (id == 0) { return; }
+
+        // the capture waited for its own frames before destroying anything, the replay may be further ahead
+        Wait(m_SubmittedValue);
+        ReplayTiming& timing = m_Timings[static_cast<std::size_t>(CaptureOp::Destroy)];
+
+        switch (type)
+        {
+        case VK_OBJECT_TYPE_IMAGE:
+        {
+            VkImage image = Take(m_Images, id);
+            VkDeviceMemory memory = m_ImageMemory.count(id) > 0 ? Take(m_ImageMemory, id) : VK_NULL_HANDLE;
+
+            Timed(timing, [&]()
+            {
+                vkDestroyImage(m_Device, image, NULL);
+                if (memory != VK_NULL_HANDLE) { vkFreeMemory(m_Device, memory, NULL); }
+            });
+
+            break;
+        }
+        case VK_OBJECT_TYPE_DEVICE_MEMORY:
+        {
+            Memory memory = Take(m_Memory, id);
+            if (memory.memory != VK_NULL_HANDLE) { Timed(timing, [&]() { vkFreeMemory(m_Device, memory.memory, NULL); }); }
+            break;
+        }
+        case VK_OBJECT_TYPE_IMAGE_VIEW:
+        {
+            VkImageView imageView = Take(m_ImageViews, id);
+            Timed(timing, [&]() { vkDestroyImageView(m_Device, imageView, NULL); });
+            break;
+        }
+        case VK_OBJECT_TYPE_SHADER_MODULE:
+        {
+            VkShaderModule shaderModule = Take(m_ShaderModules, id);
+            Timed(timing, [&]() { vkDestroyShaderModule(m_Device, shaderModule, NULL); });
+            break;
+        }
+        case VK_OBJECT_TYPE_PIPELINE_LAYOUT:
+        {
+            VkPipelineLayout pipelineLayout = Take(m_PipelineLayouts, id);
+            Timed(timing, [&]() { vkDestroyPipelineLayout(m_Device, pipelineLayout, NULL); });
+            break;
+        }
+        case VK_OBJECT_TYPE_RENDER_PASS:
+        {
+            VkRenderPass renderPass = Take(m_RenderPasses, id);
+            Timed(timing, [&]() { vkDestroyRenderPass(m_Device, renderPass, NULL); });
+            break;
+        }
+        case VK_OBJECT_TYPE_FRAMEBUFFER:
+        {
+            VkFramebuffer framebuffer = Take(m_Framebuffers, id);
+            Timed(timing, [&]() { vkDestroyFramebuffer(m_Device, framebuffer, NULL); });
+            break;
+        }
+        case VK_OBJECT_TYPE_PIPELINE:
+        {
+            VkPipeline pipeline = Take(m_Pipelines, id);
+            Timed(timing, [&]() { vkDestroyPipeline(m_Device, pipeline, NULL); });
+            break;
+        }
+        case VK_OBJECT_TYPE_COMMAND_POOL:
+        {
+            VkCommandPool commandPool = Take(m_CommandPools, id);
+            Timed(timing, [&]() { vkDestroyCommandPool(m_Device, commandPool, NULL); });
+            std::erase_if(m_CommandBuffers, [id](const auto& entry) { return entry.second.pool == id; });
+            break;
+        }
+        case VK_OBJECT_TYPE_COMMAND_BUFFER:
+        {
+            CommandBuffer commandBuffer = Take(m_CommandBuffers, id);
+            VkCommandPool commandPool = Find(m_CommandPools, commandBuffer.pool);
+            Timed(timing, [&]() { vkFreeCommandBuffers(m_Device, commandPool, 1, &commandBuffer.handle); });
+            break;
+        }
+        default:
+            throw std::runtime_error("capture destroys an object type the replay doesn't know");
+        }
+    }
+
+    void Replayer::EndFrame()
+    {
+        auto now = Clock::now();
+        double frameMs = std::chrono::duration<double, std::milli>(now - m_FrameStart).count() - m_FrameWaitMs;
+
+        if (m_FrameCount++ == 0) { m_SetupMs = frameMs; }
+        else { m_FrameTiming.Add(frameMs); }
+
+        m_FrameStart = now;
+        m_FrameWaitMs = 0.0;
+    }
+
+    VkDeviceMemory Replayer::AllocateMemory(VkDeviceSize size, std::uint32_t typeBits, VkMemoryPropertyFlags properties)
+    {
+        // falls back to any type the image can live in when this device has nothing with the captured properties
+        auto memoryType = m_GPU->FindMemoryType(typeBits, properties);
+        if (!memoryType.has_value()) { memoryType = m_GPU->FindMemoryType(typeBits, 0); }
+        if (!memoryType.has_value()) { throw std::runtime_error("no suitable memory type for replayed allocation"); }
+
+        VkMemoryAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocInfo.allocationSize = size;
+        allocInfo.memoryTypeIndex = memoryType.value();
+
+        VkDeviceMemory memory;
+        Check(Timed(m_Timings[static_cast<std::size_t>(CaptureOp::AllocateMemory)], [&]() { return vkAllocateMemory(m_Device, &allocInfo, NULL, &memory); }), CaptureOp::AllocateMemory);
+        return memory;
+    }
+
+    Replayer::CommandBuffer& Replayer::GetCommandBuffer(std::uint64_t id)
+    {
+        auto it = m_CommandBuffers.find(id);
+
+        if (it == m_CommandBuffers.end())
+        {
+            throw std::runtime_error("capture refers to command buffer " + std::to_string(id) + ", which doesn't exist");
+        }
+
+        return it->second;
+    }
+
+    void Replayer::Wait(std::uint64_t value)
+    {
+        std::uint64_t completed = 0;
+        vkGetSemaphoreCounterValue(m_Device, m_Timeline, &completed);
+
+        if (completed >= value) { return; }
+
+        auto start = Clock::now();
+
+        VkSemaphoreWaitInfo waitInfo{};
+        waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+        waitInfo.semaphoreCount = 1;
+        waitInfo.pSemaphores = &m_Timeline;
+        waitInfo.pValues = &value;
+        vkWaitSemaphores(m_Device, &waitInfo, UINT64_MAX);
+
+        double waitMs = ElapsedMs(start);
+        m_WaitTiming.Add(waitMs);
+        m_FrameWaitMs += waitMs;
+    }
+
+    void Replayer::PrintReport(std::ostream& stream) const
+    {
+        stream << std::fixed << std::setprecision(3);
+        stream << "Replayed " << m_FrameCount << " frame(s) on " << m_GPU->GetDeviceName() << ", the first took " << m_SetupMs << "ms with setup.\n";
+
+        if (m_FrameTiming.count > 0)
+        {
+            stream << "The rest took " << m_FrameTiming.totalMs / m_FrameTiming.count << "ms of CPU time on average, " << m_FrameTiming.maxMs << "ms at most.\n";
+        }
+
+        stream << "Waited " << m_WaitTiming.count << " time(s) for " << m_WaitTiming.totalMs << "ms on command buffers that were still in flight.\n\n";
+        stream << std::left << std::setw(28) << "call" << std::right << std::setw(10) << "count" << std::setw(14) << "total ms" << std::setw(12) << "avg us" << std::setw(12) << "max us" << '\n';
+
+        for (std::size_t i = 0; i < m_Timings.size(); ++i)
+        {
+            const ReplayTiming& timing = m_Timings[i];
+            if (timing.count == 0) { continue; }
+
+            stream << std::left << std::setw(28) << GetCaptureOpName(static_cast<CaptureOp>(i)) << std::right << std::setw(10) << timing.count << std::setw(14) << timing.totalMs <<
+            std::setw(12) << timing.totalMs * 1000.0 / timing.count << std::setw(12) << timing.maxMs * 1000.0 << '\n';
+        }
+
+        stream << std::defaultfloat;
+    }
+}
\ No newline at end of file
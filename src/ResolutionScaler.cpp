@@ -0,0 +1,49 @@
+#include "VkTest/ResolutionScaler.h"
+
+namespace VkTest
+{
+    ResolutionScaler::ResolutionScaler(float targetFrameTime, float minScale, float maxScale) noexcept :
+    m_TargetFrameTime(targetFrameTime), m_MinScale(minScale), m_MaxScale(maxScale), m_Scale(maxScale), m_AverageFrameTime(targetFrameTime), m_HasLastFrame(false)
+    {
+    }
+
+    void ResolutionScaler::Update() noexcept
+    {
+        auto now = std::chrono::steady_clock::now();
+
+        if (!m_HasLastFrame)
+        {
+            m_LastFrame = now;
+            m_HasLastFrame = true;
+            return;
+        }
+
+        float frameTime = std::chrono::duration<float, std::milli>(now - m_LastFrame).count();
+        m_LastFrame = now;
+        AddFrameTime(frameTime);
+    }
+
+    void ResolutionScaler::AddFrameTime(float frameTime) noexcept
+    {
+        // smooth out single-frame spikes so the target doesn't flicker between sizes
+        m_AverageFrameTime += (frameTime - m_AverageFrameTime) * 0.1f;
+
+        float ratio = m_TargetFrameTime / m_AverageFrameTime;
+
+        // dead band around the target, otherwise the scale never settles
+        if (ratio > 0.95f && ratio < 1.05f) { return; }
+
+        // cost scales with pixel count, i.e. the square of the linear scale, and only
+        // move part of the way there each frame
+        float wanted = m_Scale * std::sqrt(ratio);
+        m_Scale = std::clamp(m_Scale + (wanted - m_Scale) * 0.25f, m_MinScale, m_MaxScale);
+    }
+
+    VkExtent2D ResolutionScaler::GetRenderExtent(VkExtent2D fullExtent) const noexcept
+    {
+        VkExtent2D extent{};
+        extent.width = std::clamp(static_cast<std::uint32_t>(static_cast<float>(fullExtent.width) * m_Scale), 1u, fullExtent.width);
+        extent.height = std::clamp(static_cast<std::uint32_t>(static_cast<float>(fullExtent.height) * m_Scale), 1u, fullExtent.height);
+        return extent;
+    }
+}
\ No newline at end of file
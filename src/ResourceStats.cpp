@@ -0,0 +1,507 @@
+#include "VkTest/ResourceStats.h"
+#include "VkTest/VolkHook.h"
+
+#include <iostream>
+#include <sstream>
+#include <fstream>
+
+namespace VkTest
+{
+    namespace
+    {
+        ResourceStats* g_Stats = nullptr;
+        thread_local MemoryCategory t_Category = MemoryCategory::Other;
+
+        template<auto* Slot>
+        using Hook = VolkHook<ResourceStats, Slot>;
+
+        template<auto* Slot, VkObjectType Type, typename Handle, typename CreateInfo>
+        VKAPI_ATTR VkResult VKAPI_CALL CreateHook(VkDevice device, const CreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, Handle* pHandle)
+        {
+            VkResult result = Hook<Slot>::CallOriginal(device, pCreateInfo, pAllocator, pHandle);
+            if (result == VK_SUCCESS) { g_Stats->OnCreate(Type); }
+            return result;
+        }
+
+        template<auto* Slot, VkObjectType Type, typename Handle>
+        VKAPI_ATTR void VKAPI_CALL DestroyHook(VkDevice device, Handle handle, const VkAllocationCallbacks* pAllocator)
+        {
+            if (handle != VK_NULL_HANDLE) { g_Stats->OnDestroy(Type); }
+            Hook<Slot>::CallOriginal(device, handle, pAllocator);
+        }
+
+        template<auto* Slot, typename CreateInfo>
+        VKAPI_ATTR VkResult VKAPI_CALL PipelineHook(VkDevice device, VkPipelineCache cache, std::uint32_t count, const CreateInfo* pCreateInfos, const VkAllocationCallbacks* pAllocator, VkPipeline* pPipelines)
+        {
+            VkResult result = Hook<Slot>::CallOriginal(device, cache, count, pCreateInfos, pAllocator, pPipelines);
+            std::uint64_t created = 0;
+
+            // failed creations leave VK_NULL_HANDLE in their slot
+            for (std::uint32_t i = 0; i < count; ++i)
+            {
+                if (pPipelines[i] != VK_NULL_HANDLE) { ++created; }
+            }
+
+            if (created > 0) { g_Stats->OnCreate(VK_OBJECT_TYPE_PIPELINE, created); }
+            return result;
+        }
+
+        VKAPI_ATTR VkResult VKAPI_CALL AllocateCommandBuffersHook(VkDevice device, const VkCommandBufferAllocateInfo* pAllocateInfo, VkCommandBuffer* pCommandBuffers)
+        {
+            VkResult result = Hook<&vkAllocateCommandBuffers>::CallOriginal(device, pAllocateInfo, pCommandBuffers);
+            if (result == VK_SUCCESS) { g_Stats->OnAllocateCommandBuffers(pAllocateInfo->commandPool, pAllocateInfo->commandBufferCount); }
+            return result;
+        }
+
+        VKAPI_ATTR void VKAPI_CALL FreeCommandBuffersHook(VkDevice device, VkCommandPool commandPool, std::uint32_t count, const VkCommandBuffer* pCommandBuffers)
+        {
+            std::uint64_t freed = 0;
+
+            for (std::uint32_t i = 0; i < count; ++i)
+            {
+                if (pCommandBuffers[i] != VK_NULL_HANDLE) { ++freed; }
+            }
+
+            g_Stats->OnFreeCommandBuffers(commandPool, freed);
+            Hook<&vkFreeCommandBuffers>::CallOriginal(device, commandPool, count, pCommandBuffers);
+        }
+
+        VKAPI_ATTR void VKAPI_CALL DestroyCommandPoolHook(VkDevice device, VkCommandPool commandPool, const VkAllocationCallbacks* pAllocator)
+        {
+            // destroying a pool implicitly frees whatever was allocated from it
+            if (commandPool != VK_NULL_HANDLE) { g_Stats->OnDestroyCommandPool(commandPool); }
+            Hook<&vkDestroyCommandPool>::CallOriginal(device, commandPool, pAllocator);
+        }
+
+        VKAPI_ATTR VkResult VKAPI_CALL AllocateDescriptorSetsHook(VkDevice device, const VkDescriptorSetAllocateInfo* pAllocateInfo, VkDescriptorSet* pDescriptorSets)
+        {
+            VkResult result = Hook<&vkAllocateDescriptorSets>::CallOriginal(device, pAllocateInfo, pDescriptorSets);
+            if (result == VK_SUCCESS) { g_Stats->OnAllocateDescriptorSets(pAllocateInfo->descriptorPool, pAllocateInfo->descriptorSetCount); }
+            return result;
+        }
+
+        VKAPI_ATTR VkResult VKAPI_CALL FreeDescriptorSetsHook(VkDevice device, VkDescriptorPool descriptorPool, std::uint32_t count, const VkDescriptorSet* pDescriptorSets)
+        {
+            std::uint64_t freed = 0;
+
+            for (std::uint32_t i = 0; i < count; ++i)
+            {
+                if (pDescriptorSets[i] != VK_NULL_HANDLE) { ++freed; }
+            }
+
+            g_Stats->OnFreeDescriptorSets(descriptorPool, freed);
+            return Hook<&vkFreeDescriptorSets>::CallOriginal(device, descriptorPool, count, pDescriptorSets);
+        }
+
+        VKAPI_ATTR VkResult VKAPI_CALL ResetDescriptorPoolHook(VkDevice device, VkDescriptorPool descriptorPool, VkDescriptorPoolResetFlags flags)
+        {
+            g_Stats->OnResetDescriptorPool(descriptorPool, false);
+            return Hook<&vkResetDescriptorPool>::CallOriginal(device, descriptorPool, flags);
+        }
+
+        VKAPI_ATTR void VKAPI_CALL DestroyDescriptorPoolHook(VkDevice device, VkDescriptorPool descriptorPool, const VkAllocationCallbacks* pAllocator)
+        {
+            // like command pools, resetting or destroying a descriptor pool frees every set allocated from it
+            if (descriptorPool != VK_NULL_HANDLE) { g_Stats->OnResetDescriptorPool(descriptorPool, true); }
+            Hook<&vkDestroyDescriptorPool>::CallOriginal(device, descriptorPool, pAllocator);
+        }
+
+        VKAPI_ATTR VkResult VKAPI_CALL AllocateMemoryHook(VkDevice device, const VkMemoryAllocateInfo* pAllocateInfo, const VkAllocationCallbacks* pAllocator, VkDeviceMemory* pMemory)
+        {
+            VkResult result = Hook<&vkAllocateMemory>::CallOriginal(device, pAllocateInfo, pAllocator, pMemory);
+            if (result == VK_SUCCESS) { g_Stats->OnAllocate(*pMemory, pAllocateInfo->memoryTypeIndex, pAllocateInfo->allocationSize); }
+            return result;
+        }
+
+        VKAPI_ATTR void VKAPI_CALL FreeMemoryHook(VkDevice device, VkDeviceMemory memory, const VkAllocationCallbacks* pAllocator)
+        {
+            if (memory != VK_NULL_HANDLE) { g_Stats->OnFree(memory); }
+            Hook<&vkFreeMemory>::CallOriginal(device, memory, pAllocator);
+        }
+
+        const char* CategoryName(std::size_t category) noexcept
+        {
+            switch (static_cast<MemoryCategory>(category))
+            {
+            case MemoryCategory::RenderTarget: return "render_target";
+            case MemoryCategory::Buffer: return "buffer";
+            case MemoryCategory::Staging: return "staging";
+            default: return "other";
+            }
+        }
+
+        void Release(StatCounter& counter, std::uint64_t amount, const char* what)
+        {
+            // releasing more than was counted means a hook is missing or something was destroyed twice
+            if (!counter.Subtract(amount)) { std::cerr << "Resource stats underflow on " << what << ", the counts are off\n"; }
+        }
+
+        void WriteCounter(std::ostream& os, const StatCounter& counter)
+        {
+            os << "\"current\": " << counter.current << ", \"peak\": " << counter.peak;
+        }
+    }
+
+    const char* ResourceStats::GetObjectTypeName(VkObjectType type) noexcept
+    {
+        switch (type)
+        {
+        case VK_OBJECT_TYPE_BUFFER: return "buffer";
+        case VK_OBJECT_TYPE_IMAGE: return "image";
+        case VK_OBJECT_TYPE_IMAGE_VIEW: return "image_view";
+        case VK_OBJECT_TYPE_SHADER_MODULE: return "shader_module";
+        case VK_OBJECT_TYPE_PIPELINE_LAYOUT: return "pipeline_layout";
+        case VK_OBJECT_TYPE_PIPELINE: return "pipeline";
+        case VK_OBJECT_TYPE_RENDER_PASS: return "render_pass";
+        case VK_OBJECT_TYPE_FRAMEBUFFER: return "framebuffer";
+        case VK_OBJECT_TYPE_COMMAND_POOL: return "command_pool";
+        case VK_OBJECT_TYPE_COMMAND_BUFFER: return "command_buffer";
+        case VK_OBJECT_TYPE_SEMAPHORE: return "semaphore";
+        case VK_OBJECT_TYPE_FENCE: return "fence";
+        case VK_OBJECT_TYPE_SWAPCHAIN_KHR: return "swapchain";
+        case VK_OBJECT_TYPE_DEVICE_MEMORY: return "device_memory";
+        case VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT: return "descriptor_set_layout";
+        case VK_OBJECT_TYPE_DESCRIPTOR_POOL: return "descriptor_pool";
+        case VK_OBJECT_TYPE_DESCRIPTOR_SET: return "descriptor_set";
+        case VK_OBJECT_TYPE_SAMPLER: return "sampler";
+        case VK_OBJECT_TYPE_QUERY_POOL: return "query_pool";
+        case VK_OBJECT_TYPE_BUFFER_VIEW: return "buffer_view";
+        case VK_OBJECT_TYPE_EVENT: return "event";
+        default: return "unknown";
+        }
+    }
+
+    ResourceStats::CategoryScope::CategoryScope(MemoryCategory category) noexcept : m_Previous(t_Category)
+    {
+        t_Category = category;
+    }
+
+    ResourceStats::CategoryScope::~CategoryScope() noexcept
+    {
+        t_Category = m_Previous;
+    }
+
+    ResourceStats::ResourceStats(VkPhysicalDevice physicalDevice, bool hasMemoryBudget) :
+    m_PhysicalDevice(physicalDevice), m_HasBudget(hasMemoryBudget), m_FrameObjectsCreated(0), m_FrameAllocations(0), m_FrameAllocatedBytes(0)
+    {
+        vkGetPhysicalDeviceMemoryProperties(m_PhysicalDevice, &m_MemoryProperties);
+        m_Snapshot.heapBytes.resize(m_MemoryProperties.memoryHeapCount);
+        m_Snapshot.memoryTypeBytes.resize(m_MemoryProperties.memoryTypeCount);
+        m_Snapshot.hasBudget = m_HasBudget;
+        SampleBudget();
+    }
+
+    ResourceStats::~ResourceStats() noexcept
+    {
+        Uninstall();
+    }
+
+    void ResourceStats::Install()
+    {
+        if (g_Stats != nullptr) { throw std::runtime_error("resource stats are already installed"); }
+
+        g_Stats = this;
+        Hook<&vkCreateBuffer>::Install(&CreateHook<&vkCreateBuffer, VK_OBJECT_TYPE_BUFFER, VkBuffer, VkBufferCreateInfo>);
+        Hook<&vkDestroyBuffer>::Install(&DestroyHook<&vkDestroyBuffer, VK_OBJECT_TYPE_BUFFER, VkBuffer>);
+        Hook<&vkCreateImage>::Install(&CreateHook<&vkCreateImage, VK_OBJECT_TYPE_IMAGE, VkImage, VkImageCreateInfo>);
+        Hook<&vkDestroyImage>::Install(&DestroyHook<&vkDestroyImage, VK_OBJECT_TYPE_IMAGE, VkImage>);
+        Hook<&vkCreateImageView>::Install(&CreateHook<&vkCreateImageView, VK_OBJECT_TYPE_IMAGE_VIEW, VkImageView, VkImageViewCreateInfo>);
+        Hook<&vkDestroyImageView>::Install(&DestroyHook<&vkDestroyImageView, VK_OBJECT_TYPE_IMAGE_VIEW, VkImageView>);
+        Hook<&vkCreateShaderModule>::Install(&CreateHook<&vkCreateShaderModule, VK_OBJECT_TYPE_SHADER_MODULE, VkShaderModule, VkShaderModuleCreateInfo>);
+        Hook<&vkDestroyShaderModule>::Install(&DestroyHook<&vkDestroyShaderModule, VK_OBJECT_TYPE_SHADER_MODULE, VkShaderModule>);
+        Hook<&vkCreatePipelineLayout>::Install(&CreateHook<&vkCreatePipelineLayout, VK_OBJECT_TYPE_PIPELINE_LAYOUT, VkPipelineLayout, VkPipelineLayoutCreateInfo>);
+        Hook<&vkDestroyPipelineLayout>::Install(&DestroyHook<&vkDestroyPipelineLayout, VK_OBJECT_TYPE_PIPELINE_LAYOUT, VkPipelineLayout>);
+        Hook<&vkCreateGraphicsPipelines>::Install(&PipelineHook<&vkCreateGraphicsPipelines, VkGraphicsPipelineCreateInfo>);
+        Hook<&vkCreateComputePipelines>::Install(&PipelineHook<&vkCreateComputePipelines, VkComputePipelineCreateInfo>);
+        Hook<&vkDestroyPipeline>::Install(&DestroyHook<&vkDestroyPipeline, VK_OBJECT_TYPE_PIPELINE, VkPipeline>);
+        Hook<&vkCreateRenderPass>::Install(&CreateHook<&vkCreateRenderPass, VK_OBJECT_TYPE_RENDER_PASS, VkRenderPass, VkRenderPassCreateInfo>);
+        Hook<&vkDestroyRenderPass>::Install(&DestroyHook<&vkDestroyRenderPass, VK_OBJECT_TYPE_RENDER_PASS, VkRenderPass>);
+        Hook<&vkCreateFramebuffer>::Install(&CreateHook<&vkCreateFramebuffer, VK_OBJECT_TYPE_FRAMEBUFFER, VkFramebuffer, VkFramebufferCreateInfo>);
+        Hook<&vkDestroyFramebuffer>::Install(&DestroyHook<&vkDestroyFramebuffer, VK_OBJECT_TYPE_FRAMEBUFFER, VkFramebuffer>);
+        Hook<&vkCreateCommandPool>::Install(&CreateHook<&vkCreateCommandPool, VK_OBJECT_TYPE_COMMAND_POOL, VkCommandPool, VkCommandPoolCreateInfo>);
+        Hook<&vkCreateSemaphore>::Install(&CreateHook<&vkCreateSemaphore, VK_OBJECT_TYPE_SEMAPHORE, VkSemaphore, VkSemaphoreCreateInfo>);
+        Hook<&vkDestroySemaphore>::Install(&DestroyHook<&vkDestroySemaphore, VK_OBJECT_TYPE_SEMAPHORE, VkSemaphore>);
+        Hook<&vkCreateFence>::Install(&CreateHook<&vkCreateFence, VK_OBJECT_TYPE_FENCE, VkFence, VkFenceCreateInfo>);
+        Hook<&vkDestroyFence>::Install(&DestroyHook<&vkDestroyFence, VK_OBJECT_TYPE_FENCE, VkFence>);
+        Hook<&vkCreateSwapchainKHR>::Install(&CreateHook<&vkCreateSwapchainKHR, VK_OBJECT_TYPE_SWAPCHAIN_KHR, VkSwapchainKHR, VkSwapchainCreateInfoKHR>);
+        Hook<&vkDestroySwapchainKHR>::Install(&DestroyHook<&vkDestroySwapchainKHR, VK_OBJECT_TYPE_SWAPCHAIN_KHR, VkSwapchainKHR>);
+        Hook<&vkCreateDescriptorSetLayout>::Install(&CreateHook<&vkCreateDescriptorSetLayout, VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT, VkDescriptorSetLayout, VkDescriptorSetLayoutCreateInfo>);
+        Hook<&vkDestroyDescriptorSetLayout>::Install(&DestroyHook<&vkDestroyDescriptorSetLayout, VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT, VkDescriptorSetLayout>);
+        Hook<&vkCreateDescriptorPool>::Install(&CreateHook<&vkCreateDescriptorPool, VK_OBJECT_TYPE_DESCRIPTOR_POOL, VkDescriptorPool, VkDescriptorPoolCreateInfo>);
+        Hook<&vkCreateSampler>::Install(&CreateHook<&vkCreateSampler, VK_OBJECT_TYPE_SAMPLER, VkSampler, VkSamplerCreateInfo>);
+        Hook<&vkDestroySampler>::Install(&DestroyHook<&vkDestroySampler, VK_OBJECT_TYPE_SAMPLER, VkSampler>);
+        Hook<&vkCreateQueryPool>::Install(&CreateHook<&vkCreateQueryPool, VK_OBJECT_TYPE_QUERY_POOL, VkQueryPool, VkQueryPoolCreateInfo>);
+        Hook<&vkDestroyQueryPool>::Install(&DestroyHook<&vkDestroyQueryPool, VK_OBJECT_TYPE_QUERY_POOL, VkQueryPool>);
+        Hook<&vkCreateBufferView>::Install(&CreateHook<&vkCreateBufferView, VK_OBJECT_TYPE_BUFFER_VIEW, VkBufferView, VkBufferViewCreateInfo>);
+        Hook<&vkDestroyBufferView>::Install(&DestroyHook<&vkDestroyBufferView, VK_OBJECT_TYPE_BUFFER_VIEW, VkBufferView>);
+        Hook<&vkCreateEvent>::Install(&CreateHook<&vkCreateEvent, VK_OBJECT_TYPE_EVENT, VkEvent, VkEventCreateInfo>);
+        Hook<&vkDestroyEvent>::Install(&DestroyHook<&vkDestroyEvent, VK_OBJECT_TYPE_EVENT, VkEvent>);
+        Hook<&vkAllocateCommandBuffers>::Install(&AllocateCommandBuffersHook);
+        Hook<&vkFreeCommandBuffers>::Install(&FreeCommandBuffersHook);
+        Hook<&vkDestroyCommandPool>::Install(&DestroyCommandPoolHook);
+        Hook<&vkAllocateDescriptorSets>::Install(&AllocateDescriptorSetsHook);
+        Hook<&vkFreeDescriptorSets>::Install(&FreeDescriptorSetsHook);
+        Hook<&vkResetDescriptorPool>::Install(&ResetDescriptorPoolHook);
+        Hook<&vkDestroyDescriptorPool>::Install(&DestroyDescriptorPoolHook);
+        Hook<&vkAllocateMemory>::Install(&AllocateMemoryHook);
+        Hook<&vkFreeMemory>::Install(&FreeMemoryHook);
+    }
+
+    void ResourceStats::Uninstall() noexcept
+    {
+        if (g_Stats != this) { return; }
+
+        Hook<&vkCreateBuffer>::Uninstall();
+        Hook<&vkDestroyBuffer>::Uninstall();
+        Hook<&vkCreateImage>::Uninstall();
+        Hook<&vkDestroyImage>::Uninstall();
+        Hook<&vkCreateImageView>::Uninstall();
+        Hook<&vkDestroyImageView>::Uninstall();
+        Hook<&vkCreateShaderModule>::Uninstall();
+        Hook<&vkDestroyShaderModule>::Uninstall();
+        Hook<&vkCreatePipelineLayout>::Uninstall();
+        Hook<&vkDestroyPipelineLayout>::Uninstall();
+        Hook<&vkCreateGraphicsPipelines>::Uninstall();
+        Hook<&vkCreateComputePipelines>::Uninstall();
+        Hook<&vkDestroyPipeline>::Uninstall();
+        Hook<&vkCreateRenderPass>::Uninstall();
+        Hook<&vkDestroyRenderPass>::Uninstall();
+        Hook<&vkCreateFramebuffer>::Uninstall();
+        Hook<&vkDestroyFramebuffer>::Uninstall();
+        Hook<&vkCreateCommandPool>::Uninstall();
+        Hook<&vkCreateSemaphore>::Uninstall();
+        Hook<&vkDestroySemaphore>::Uninstall();
+        Hook<&vkCreateFence>::Uninstall();
+        Hook<&vkDestroyFence>::Uninstall();
+        Hook<&vkCreateSwapchainKHR>::Uninstall();
+        Hook<&vkDestroySwapchainKHR>::Uninstall();
+        Hook<&vkCreateDescriptorSetLayout>::Uninstall();
+        Hook<&vkDestroyDescriptorSetLayout>::Uninstall();
+        Hook<&vkCreateDescriptorPool>::Uninstall();
+        Hook<&vkCreateSampler>::Uninstall();
+        Hook<&vkDestroySampler>::Uninstall();
+        Hook<&vkCreateQueryPool>::Uninstall();
+        Hook<&vkDestroyQueryPool>::Uninstall();
+        Hook<&vkCreateBufferView>::Uninstall();
+        Hook<&vkDestroyBufferView>::Uninstall();
+        Hook<&vkCreateEvent>::Uninstall();
+        Hook<&vkDestroyEvent>::Uninstall();
+        Hook<&vkAllocateCommandBuffers>::Uninstall();
+        Hook<&vkFreeCommandBuffers>::Uninstall();
+        Hook<&vkDestroyCommandPool>::Uninstall();
+        Hook<&vkAllocateDescriptorSets>::Uninstall();
+        Hook<&vkFreeDescriptorSets>::Uninstall();
+        Hook<&vkResetDescriptorPool>::Uninstall();
+        Hook<&vkDestroyDescriptorPool>::Uninstall();
+        Hook<&vkAllocateMemory>::Uninstall();
+        Hook<&vkFreeMemory>::Uninstall();
+        g_Stats = nullptr;
+    }
+
+    void ResourceStats::OnCreate(VkObjectType type, std::uint64_t count)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Snapshot.objects[type].Add(count);
+        m_FrameObjectsCreated += count;
+    }
+
+    void ResourceStats::OnDestroy(VkObjectType type, std::uint64_t count)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        Release(m_Snapshot.objects[type], count, GetObjectTypeName(type));
+    }
+
+    void ResourceStats::OnAllocateCommandBuffers(VkCommandPool pool, std::uint64_t count)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Snapshot.objects[VK_OBJECT_TYPE_COMMAND_BUFFER].Add(count);
+        m_PoolCommandBuffers[pool] += count;
+        m_FrameObjectsCreated += count;
+    }
+
+    void ResourceStats::OnFreeCommandBuffers(VkCommandPool pool, std::uint64_t count)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        Release(m_Snapshot.objects[VK_OBJECT_TYPE_COMMAND_BUFFER], count, "command_buffer");
+        auto& live = m_PoolCommandBuffers[pool];
+        live -= count < live ? count : live;
+    }
+
+    void ResourceStats::OnDestroyCommandPool(VkCommandPool pool)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        Release(m_Snapshot.objects[VK_OBJECT_TYPE_COMMAND_POOL], 1, "command_pool");
+        auto it = m_PoolCommandBuffers.find(pool);
+
+        if (it != m_PoolCommandBuffers.end())
+        {
+            Release(m_Snapshot.objects[VK_OBJECT_TYPE_COMMAND_BUFFER], it->second, "command_buffer");
+            m_PoolCommandBuffers.erase(it);
+        }
+    }
+
+    void ResourceStats::OnAllocateDescriptorSets(VkDescriptorPool pool, std::uint64_t count)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Snapshot.objects[VK_OBJECT_TYPE_DESCRIPTOR_SET].Add(count);
+        m_PoolDescriptorSets[pool] += count;
+        m_FrameObjectsCreated += count;
+    }
+
+    void ResourceStats::OnFreeDescriptorSets(VkDescriptorPool pool, std::uint64_t count)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        Release(m_Snapshot.objects[VK_OBJECT_TYPE_DESCRIPTOR_SET], count, "descriptor_set");
+        auto& live = m_PoolDescriptorSets[pool];
+        live -= count < live ? count : live;
+    }
+
+    void ResourceStats::OnResetDescriptorPool(VkDescriptorPool pool, bool destroyed)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        if (destroyed) { Release(m_Snapshot.objects[VK_OBJECT_TYPE_DESCRIPTOR_POOL], 1, "descriptor_pool"); }
+
+        auto it = m_PoolDescriptorSets.find(pool);
+
+        if (it != m_PoolDescriptorSets.end())
+        {
+            Release(m_Snapshot.objects[VK_OBJECT_TYPE_DESCRIPTOR_SET], it->second, "descriptor_set");
+            m_PoolDescriptorSets.erase(it);
+        }
+    }
+
+    void ResourceStats::OnAllocate(VkDeviceMemory memory, std::uint32_t memoryType, VkDeviceSize size)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Allocations[memory] = {memoryType, size, t_Category};
+        m_Snapshot.objects[VK_OBJECT_TYPE_DEVICE_MEMORY].Add(1);
+        m_Snapshot.memoryTypeBytes[memoryType].Add(size);
+        m_Snapshot.heapBytes[m_MemoryProperties.memoryTypes[memoryType].heapIndex].Add(size);
+        m_Snapshot.categoryBytes[static_cast<std::size_t>(t_Category)].Add(size);
+        ++m_FrameAllocations;
+        m_FrameAllocatedBytes += size;
+    }
+
+    void ResourceStats::OnFree(VkDeviceMemory memory)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        auto it = m_Allocations.find(memory);
+
+        if (it == m_Allocations.end()) { return; }
+
+        const Allocation& allocation = it->second;
+        Release(m_Snapshot.objects[VK_OBJECT_TYPE_DEVICE_MEMORY], 1, "device_memory");
+        Release(m_Snapshot.memoryTypeBytes[allocation.memoryType], allocation.size, "memory type bytes");
+        Release(m_Snapshot.heapBytes[m_MemoryProperties.memoryTypes[allocation.memoryType].heapIndex], allocation.size, "heap bytes");
+        Release(m_Snapshot.categoryBytes[static_cast<std::size_t>(allocation.category)], allocation.size, "category bytes");
+        m_Allocations.erase(it);
+    }
+
+    void ResourceStats::SampleBudget()
+    {
+        if (!m_HasBudget) { return; }
+
+        VkPhysicalDeviceMemoryBudgetPropertiesEXT budgetProperties{};
+        budgetProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+
+        VkPhysicalDeviceMemoryProperties2 memoryProperties{};
+        memoryProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+        memoryProperties.pNext = &budgetProperties;
+        vkGetPhysicalDeviceMemoryProperties2(m_PhysicalDevice, &memoryProperties);
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        std::uint32_t heapCount = memoryProperties.memoryProperties.memoryHeapCount;
+        m_Snapshot.heapBudget.assign(budgetProperties.heapBudget, budgetProperties.heapBudget + heapCount);
+        m_Snapshot.heapUsage.assign(budgetProperties.heapUsage, budgetProperties.heapUsage + heapCount);
+    }
+
+    void ResourceStats::EndFrame(bool sampleBudget, std::uint64_t heapAllocations)
+    {
+        // the budget query goes to the driver, so it isn't done every frame
+        if (sampleBudget) { SampleBudget(); }
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        ++m_Snapshot.frame;
+        m_Snapshot.frameObjectsCreated = m_FrameObjectsCreated;
+        m_Snapshot.frameAllocations = m_FrameAllocations;
+        m_Snapshot.frameAllocatedBytes = m_FrameAllocatedBytes;
+        m_Snapshot.frameHeapAllocations = heapAllocations;
+        m_FrameObjectsCreated = 0;
+        m_FrameAllocations = 0;
+        m_FrameAllocatedBytes = 0;
+    }
+
+    ResourceSnapshot ResourceStats::GetSnapshot() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Snapshot;
+    }
+
+    std::string ResourceStats::ToJson() const
+    {
+        ResourceSnapshot snapshot = GetSnapshot();
+        std::ostringstream os;
+
+        os << "{\n  \"frame\": " << snapshot.frame << ",\n  \"objects\": {";
+
+        bool first = true;
+
+        for (const auto& [type, counter] : snapshot.objects)
+        {
+            os << (first ? "\n" : ",\n") << "    \"" << GetObjectTypeName(type) << "\": {";
+            WriteCounter(os, counter);
+            os << '}';
+            first = false;
+        }
+
+        os << "\n  },\n  \"heaps\": [";
+
+        for (std::size_t i = 0; i < snapshot.heapBytes.size(); ++i)
+        {
+            os << (i == 0 ? "\n" : ",\n") << "    {\"index\": " << i << ", \"size\": " << m_MemoryProperties.memoryHeaps[i].size <<
+            ", \"device_local\": " << ((m_MemoryProperties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) ? "true" : "false") << ", ";
+            WriteCounter(os, snapshot.heapBytes[i]);
+
+            if (snapshot.hasBudget && i < snapshot.heapBudget.size())
+            {
+                os << ", \"budget\": " << snapshot.heapBudget[i] << ", \"usage\": " << snapshot.heapUsage[i];
+            }
+
+            os << '}';
+        }
+
+        os << "\n  ],\n  \"memory_types\": [";
+
+        for (std::size_t i = 0; i < snapshot.memoryTypeBytes.size(); ++i)
+        {
+            os << (i == 0 ? "\n" : ",\n") << "    {\"index\": " << i << ", \"heap\": " << m_MemoryProperties.memoryTypes[i].heapIndex <<
+            ", \"flags\": " << m_MemoryProperties.memoryTypes[i].propertyFlags << ", ";
+            WriteCounter(os, snapshot.memoryTypeBytes[i]);
+            os << '}';
+        }
+
+        os << "\n  ],\n  \"categories\": {";
+
+        for (std::size_t i = 0; i < snapshot.categoryBytes.size(); ++i)
+        {
+            os << (i == 0 ? "\n" : ",\n") << "    \"" << CategoryName(i) << "\": {";
+            WriteCounter(os, snapshot.categoryBytes[i]);
+            os << '}';
+        }
+
+        os << "\n  },\n  \"last_frame\": {\"objects_created\": " << snapshot.frameObjectsCreated << ", \"allocations\": " << snapshot.frameAllocations <<
+        ", \"allocated_bytes\": " << snapshot.frameAllocatedBytes << ", \"heap_allocations\": " << snapshot.frameHeapAllocations << "}\n}\n";
+        return os.str();
+    }
+
+    bool ResourceStats::WriteJson(const std::string& path) const
+    {
+        std::ofstream file(path, std::ios::trunc);
+
+        if (!file.is_open()) { return false; }
+
+        file << ToJson();
+        return file.good();
+    }
+}
\ No newline at end of file
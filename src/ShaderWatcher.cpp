@@ -0,0 +1,182 @@
+#include "VkTest/ShaderWatcher.h"
+
+#include <iostream>
+#include <set>
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <sys/eventfd.h>
+#include <sys/wait.h>
+#include <poll.h>
+#include <spawn.h>
+#include <unistd.h>
+
+extern char** environ;
+#endif
+
+namespace VkTest
+{
+    ShaderWatcher::ShaderWatcher(const std::string& directory, const std::string& compiler, std::function<void(const std::vector<std::string>&)> onRebuilt) :
+    m_Directory(directory), m_Compiler(compiler), m_OnRebuilt(std::move(onRebuilt)), m_InotifyFd(-1), m_WakeFd(-1)
+    {
+    #ifdef __linux__
+        m_InotifyFd = inotify_init1(IN_CLOEXEC);
+
+        if (m_InotifyFd < 0) { throw std::runtime_error("couldn't initialise inotify"); }
+
+        // editors either rewrite in place or save to a temporary and rename it over the original
+        if (inotify_add_watch(m_InotifyFd, m_Directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+        {
+            close(m_InotifyFd);
+            throw std::runtime_error("couldn't watch '" + m_Directory + "'");
+        }
+
+        m_WakeFd = eventfd(0, EFD_CLOEXEC);
+
+        if (m_WakeFd < 0)
+        {
+            close(m_InotifyFd);
+            throw std::runtime_error("couldn't create shader watcher wake event");
+        }
+
+        m_Thread = std::thread(&ShaderWatcher::Watch, this);
+    #else
+        throw std::runtime_error("shader hot reload needs inotify");
+    #endif
+    }
+
+    ShaderWatcher::~ShaderWatcher() noexcept
+    {
+    #ifdef __linux__
+        // a blocking eventfd write can only fail on a bad descriptor, which the constructor rules out
+        std::uint64_t wake = 1;
+
+        if (write(m_WakeFd, &wake, sizeof(wake)) != static_cast<ssize_t>(sizeof(wake)))
+        {
+            std::cerr << "Failed to wake the shader watcher thread\n";
+        }
+
+        if (m_Thread.joinable())
+        {
+            m_Thread.join();
+        }
+
+        close(m_WakeFd);
+        close(m_InotifyFd);
+    #endif
+    }
+
+    bool ShaderWatcher::Compile(const std::string& name) const
+    {
+        const char* stage = nullptr;
+
+        if (name.rfind("vert", 0) == 0) { stage = "vertex"; }
+        else if (name.rfind("frag", 0) == 0) { stage = "fragment"; }
+        else if (name.rfind("comp", 0) == 0) { stage = "compute"; }
+
+        if (stage == nullptr)
+        {
+            std::cerr << "Can't tell the shader stage of '" << name << ".glsl', skipping\n";
+            return false;
+        }
+
+    #ifdef __linux__
+        std::string compiler = m_Compiler;
+        std::string source = m_Directory + "/" + name + ".glsl";
+        std::string output = m_Directory + "/" + name + ".spv";
+        std::string stageArg = std::string("-fshader-stage=") + stage;
+
+        // no shell in between, so file names with spaces or quotes reach the compiler as they are
+        char* argv[] = {compiler.data(), stageArg.data(), source.data(), const_cast<char*>("-o"), output.data(), nullptr};
+        pid_t pid;
+        int error = posix_spawnp(&pid, compiler.c_str(), nullptr, nullptr, argv, environ);
+
+        if (error != 0)
+        {
+            std::cerr << "Failed to run '" << m_Compiler << "': " << std::strerror(error) << '\n';
+            return false;
+        }
+
+        int status = 0;
+
+        while (waitpid(pid, &status, 0) < 0)
+        {
+            if (errno != EINTR)
+            {
+                std::cerr << "Failed to wait for '" << m_Compiler << "'\n";
+                return false;
+            }
+        }
+
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        {
+            std::cerr << "Failed to compile '" << source << "', keeping the old pipeline\n";
+            return false;
+        }
+
+        return true;
+    #else
+        return false;
+    #endif
+    }
+
+    void ShaderWatcher::Watch()
+    {
+    #ifdef __linux__
+        alignas(inotify_event) char buffer[4096];
+        pollfd fds[2] = {{m_InotifyFd, POLLIN, 0}, {m_WakeFd, POLLIN, 0}};
+        std::set<std::string> changed;
+
+        while (true)
+        {
+            // saves often come as several events, wait for them to settle before compiling
+            int ready = poll(fds, 2, changed.empty() ? -1 : 100);
+
+            if (ready < 0)
+            {
+                if (errno == EINTR) { continue; }
+                break;
+            }
+
+            if (fds[1].revents & POLLIN) { break; }
+
+            if (ready == 0)
+            {
+                std::vector<std::string> rebuilt;
+
+                for (const auto& name : changed)
+                {
+                    if (Compile(name)) { rebuilt.push_back(name); }
+                }
+
+                changed.clear();
+
+                if (!rebuilt.empty()) { m_OnRebuilt(rebuilt); }
+
+                continue;
+            }
+
+            ssize_t length = read(m_InotifyFd, buffer, sizeof(buffer));
+
+            for (char* ptr = buffer; ptr < buffer + length;)
+            {
+                const auto* event = reinterpret_cast<const inotify_event*>(ptr);
+
+                if (event->len > 0)
+                {
+                    std::string fileName(event->name);
+
+                    if (fileName.size() > 5 && fileName.compare(fileName.size() - 5, 5, ".glsl") == 0)
+                    {
+                        changed.insert(fileName.substr(0, fileName.size() - 5));
+                    }
+                }
+
+                ptr += sizeof(inotify_event) + event->len;
+            }
+        }
+    #endif
+    }
+}
\ No newline at end of file
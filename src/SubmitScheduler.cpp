@@ -0,0 +1,182 @@
+#include "VkTest/SubmitScheduler.h"
+
+namespace VkTest
+{
+    namespace
+    {
+        struct SubmitGroup
+        {
+            SubmitGroup(std::pmr::memory_resource* memory) : commandBuffers(memory), waits(memory), signals(memory) {}
+
+            std::pmr::vector<VkCommandBufferSubmitInfo> commandBuffers;
+            std::pmr::vector<VkSemaphoreSubmitInfo> waits;
+            std::pmr::vector<VkSemaphoreSubmitInfo> signals;
+        };
+
+        VkSemaphoreSubmitInfo ToSubmitInfo(const TimelineWait& wait) noexcept
+        {
+            VkSemaphoreSubmitInfo info{};
+            info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+            info.semaphore = wait.semaphore;
+            info.value = wait.value;
+            info.stageMask = wait.stage;
+            return info;
+        }
+    }
+
+    SubmitScheduler::SubmitScheduler(VkDevice device) noexcept : m_Device(device), m_LastSubmitCount(0)
+    {
+    }
+
+    SubmitScheduler::~SubmitScheduler() noexcept
+    {
+        WaitIdle();
+
+        for (const auto& queue : m_Queues)
+        {
+            vkDestroySemaphore(m_Device, queue.timeline, NULL);
+        }
+    }
+
+    SubmitScheduler::QueueId SubmitScheduler::AddQueue(VkQueue queue)
+    {
+        // two producers sharing a VkQueue have to share its timeline too
+        for (QueueId id = 0; id < m_Queues.size(); ++id)
+        {
+            if (m_Queues[id].queue == queue)
+            {
+                ++m_Queues[id].producers;
+                return id;
+            }
+        }
+
+        VkSemaphoreTypeCreateInfo timelineCreateInfo{};
+        timelineCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+        timelineCreateInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+        timelineCreateInfo.initialValue = 0;
+
+        VkSemaphoreCreateInfo semaphoreCreateInfo{};
+        semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        semaphoreCreateInfo.pNext = &timelineCreateInfo;
+
+        Queue& added = m_Queues.emplace_back();
+        added.queue = queue;
+        added.submittedValue = 0;
+        added.producers = 1;
+
+        if (vkCreateSemaphore(m_Device, &semaphoreCreateInfo, NULL, &added.timeline) != VK_SUCCESS)
+        {
+            m_Queues.pop_back();
+            throw std::runtime_error("failed to create queue timeline semaphore");
+        }
+
+        return static_cast<QueueId>(m_Queues.size() - 1);
+    }
+
+    void SubmitScheduler::Enqueue(QueueId id, SubmitBatch batch)
+    {
+        m_Queues[id].pending.push_back(std::move(batch));
+    }
+
+    void SubmitScheduler::Flush()
+    {
+        m_LastSubmitCount = 0;
+
+        for (auto& queue : m_Queues)
+        {
+            if (queue.pending.empty()) { continue; }
+
+            // a batch joins the previous VkSubmitInfo2 unless that would delay one of its waits'
+            // effects onto earlier work or hold back an earlier batch's signals
+            std::pmr::vector<SubmitGroup> groups(&m_Arena);
+            groups.reserve(queue.pending.size());
+
+            for (const auto& batch : queue.pending)
+            {
+                // a wait on the queue's own timeline would be signalled by the last group of this same
+                // submit at the earliest and hang the device. submission order already covers it, the
+                // producer is responsible for the barrier that makes the memory visible
+                bool waits = false;
+
+                for (const auto& wait : batch.waits)
+                {
+                    if (wait.semaphore != queue.timeline) { waits = true; break; }
+                }
+
+                if (groups.empty() || waits || !groups.back().signals.empty())
+                {
+                    groups.emplace_back(&m_Arena);
+                }
+
+                SubmitGroup& group = groups.back();
+
+                for (auto commandBuffer : batch.commandBuffers)
+                {
+                    VkCommandBufferSubmitInfo info{};
+                    info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO;
+                    info.commandBuffer = commandBuffer;
+                    group.commandBuffers.push_back(info);
+                }
+
+                for (const auto& wait : batch.waits)
+                {
+                    if (wait.semaphore != queue.timeline) { group.waits.push_back(ToSubmitInfo(wait)); }
+                }
+                for (const auto& signal : batch.signals) { group.signals.push_back(ToSubmitInfo(signal)); }
+            }
+
+            groups.back().signals.push_back(ToSubmitInfo({queue.timeline, queue.submittedValue + 1, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT}));
+
+            std::pmr::vector<VkSubmitInfo2> submitInfos(groups.size(), &m_Arena);
+
+            for (std::size_t i = 0; i < groups.size(); ++i)
+            {
+                submitInfos[i] = {};
+                submitInfos[i].sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
+                submitInfos[i].waitSemaphoreInfoCount = static_cast<std::uint32_t>(groups[i].waits.size());
+                submitInfos[i].pWaitSemaphoreInfos = groups[i].waits.data();
+                submitInfos[i].commandBufferInfoCount = static_cast<std::uint32_t>(groups[i].commandBuffers.size());
+                submitInfos[i].pCommandBufferInfos = groups[i].commandBuffers.data();
+                submitInfos[i].signalSemaphoreInfoCount = static_cast<std::uint32_t>(groups[i].signals.size());
+                submitInfos[i].pSignalSemaphoreInfos = groups[i].signals.data();
+            }
+
+            if (vkQueueSubmit2(queue.queue, static_cast<std::uint32_t>(submitInfos.size()), submitInfos.data(), VK_NULL_HANDLE) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to submit queued work");
+            }
+
+            ++queue.submittedValue;
+            ++m_LastSubmitCount;
+            queue.pending.clear();
+        }
+
+        // the pending batches were the last users of the arena
+        m_Arena.Reset();
+    }
+
+    std::uint64_t SubmitScheduler::GetCompletedValue(QueueId id) const
+    {
+        std::uint64_t value = 0;
+        vkGetSemaphoreCounterValue(m_Device, m_Queues[id].timeline, &value);
+        return value;
+    }
+
+    void SubmitScheduler::Wait(QueueId id, std::uint64_t value) const
+    {
+        VkSemaphoreWaitInfo waitInfo{};
+        waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+        waitInfo.semaphoreCount = 1;
+        waitInfo.pSemaphores = &m_Queues[id].timeline;
+        waitInfo.pValues = &value;
+        vkWaitSemaphores(m_Device, &waitInfo, UINT64_MAX);
+    }
+
+    void SubmitScheduler::WaitIdle() const
+    {
+        for (QueueId id = 0; id < m_Queues.size(); ++id)
+        {
+            Wait(id, m_Queues[id].submittedValue);
+        }
+    }
+}
\ No newline at end of file
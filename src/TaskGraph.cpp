@@ -0,0 +1,183 @@
+#include "VkTest/TaskGraph.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <stdexcept>
+
+namespace VkTest
+{
+    TaskGraph::TaskGraph() noexcept : m_InFlight(0)
+    {
+    }
+
+    TaskGraph::TaskId TaskGraph::Add(std::string name, std::function<void()> work, std::vector<TaskId> dependencies, Affinity affinity)
+    {
+        TaskId id = m_Tasks.size();
+
+        for (auto dependency : dependencies)
+        {
+            if (dependency >= id) { throw std::runtime_error("task '" + name + "' depends on a task that doesn't exist yet"); }
+
+            m_Tasks[dependency].dependents.push_back(id);
+        }
+
+        Task& task = m_Tasks.emplace_back();
+        task.name = std::move(name);
+        task.work = std::move(work);
+        task.dependencies = std::move(dependencies);
+        task.affinity = affinity;
+        task.remaining = 0;
+        return id;
+    }
+
+    void TaskGraph::Dispatch(ThreadPool& pool, TaskId id)
+    {
+        ++m_InFlight;
+
+        if (m_Tasks[id].affinity == Affinity::MainThread)
+        {
+            m_MainThreadTasks.push_back(id);
+            m_Condition.notify_all();
+        }
+        else
+        {
+            pool.Enqueue([this, &pool, id]() { Execute(pool, id); });
+        }
+    }
+
+    void TaskGraph::Execute(ThreadPool& pool, TaskId id)
+    {
+        Task& task = m_Tasks[id];
+        std::exception_ptr error;
+        task.start = Clock::now();
+
+        try
+        {
+            task.work();
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+
+        task.end = Clock::now();
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        if (!m_Error) { m_Error = std::move(error); }
+
+        // after a failure nothing new is started, only what's already running gets to finish
+        if (!m_Error)
+        {
+            for (auto dependent : task.dependents)
+            {
+                if (--m_Tasks[dependent].remaining == 0) { Dispatch(pool, dependent); }
+            }
+        }
+
+        --m_InFlight;
+        m_Condition.notify_all();
+    }
+
+    void TaskGraph::Run(ThreadPool& pool)
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_Start = Clock::now();
+        m_Error = nullptr;
+
+        for (auto& task : m_Tasks)
+        {
+            task.remaining = task.dependencies.size();
+        }
+
+        for (TaskId id = 0; id < m_Tasks.size(); ++id)
+        {
+            if (m_Tasks[id].remaining == 0) { Dispatch(pool, id); }
+        }
+
+        while (true)
+        {
+            m_Condition.wait(lock, [this]() { return !m_MainThreadTasks.empty() || m_InFlight == 0; });
+
+            if (m_MainThreadTasks.empty()) { break; }
+
+            TaskId id = m_MainThreadTasks.front();
+            m_MainThreadTasks.pop_front();
+            lock.unlock();
+            Execute(pool, id);
+            lock.lock();
+        }
+
+        m_End = Clock::now();
+
+        if (m_Error) { std::rethrow_exception(m_Error); }
+    }
+
+    double TaskGraph::GetDuration(TaskId id) const noexcept
+    {
+        return std::chrono::duration<double, std::milli>(m_Tasks[id].end - m_Tasks[id].start).count();
+    }
+
+    std::vector<TaskGraph::TaskId> TaskGraph::GetCriticalPath() const
+    {
+        if (m_Tasks.empty()) { return {}; }
+
+        // longest chain by measured duration, ids are topologically ordered so one pass does it
+        std::vector<double> finish(m_Tasks.size());
+        std::vector<TaskId> previous(m_Tasks.size(), m_Tasks.size());
+
+        for (TaskId id = 0; id < m_Tasks.size(); ++id)
+        {
+            double start = 0.0;
+
+            for (auto dependency : m_Tasks[id].dependencies)
+            {
+                if (finish[dependency] > start)
+                {
+                    start = finish[dependency];
+                    previous[id] = dependency;
+                }
+            }
+
+            finish[id] = start + GetDuration(id);
+        }
+
+        std::vector<TaskId> path;
+
+        for (TaskId id = static_cast<TaskId>(std::max_element(finish.begin(), finish.end()) - finish.begin()); id < m_Tasks.size(); id = previous[id])
+        {
+            path.push_back(id);
+        }
+
+        std::reverse(path.begin(), path.end());
+        return path;
+    }
+
+    void TaskGraph::PrintReport(std::ostream& stream) const
+    {
+        double wall = std::chrono::duration<double, std::milli>(m_End - m_Start).count();
+        double work = 0.0;
+        double critical = 0.0;
+
+        for (TaskId id = 0; id < m_Tasks.size(); ++id)
+        {
+            work += GetDuration(id);
+        }
+
+        std::vector<TaskId> path = GetCriticalPath();
+
+        for (auto id : path)
+        {
+            critical += GetDuration(id);
+        }
+
+        stream << std::fixed << std::setprecision(2);
+        stream << "Startup took " << wall << "ms for " << work << "ms of work, critical path " << critical << "ms:\n";
+
+        for (auto id : path)
+        {
+            stream << "    " << m_Tasks[id].name << ": " << GetDuration(id) << "ms\n";
+        }
+
+        stream << std::defaultfloat;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,130 @@
+#include "VkTest/ThreadPool.h"
+
+#include <atomic>
+#include <memory>
+#include <algorithm>
+#include <exception>
+
+namespace VkTest
+{
+    ThreadPool::ThreadPool(std::size_t threadCount) : m_Stopping(false)
+    {
+        for (std::size_t i = 0; i < threadCount; ++i)
+        {
+            m_Threads.emplace_back(&ThreadPool::Work, this);
+        }
+    }
+
+    ThreadPool::~ThreadPool() noexcept
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Stopping = true;
+        }
+
+        m_Condition.notify_all();
+
+        for (auto& thread : m_Threads)
+        {
+            thread.join();
+        }
+    }
+
+    void ThreadPool::Work()
+    {
+        while (true)
+        {
+            std::function<void()> task;
+
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                m_Condition.wait(lock, [this]() { return m_Stopping || !m_Tasks.empty(); });
+
+                if (m_Tasks.empty()) { return; }
+
+                task = std::move(m_Tasks.front());
+                m_Tasks.pop_front();
+            }
+
+            task();
+        }
+    }
+
+    void ThreadPool::Enqueue(std::function<void()> task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Tasks.push_back(std::move(task));
+        }
+
+        m_Condition.notify_one();
+    }
+
+    void ThreadPool::ParallelFor(std::size_t count, const std::function<void(std::size_t)>& task)
+    {
+        if (count == 0) { return; }
+
+        // nothing to share, and skipping the shared state keeps small calls off the heap
+        if (count == 1 || m_Threads.empty())
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                task(i);
+            }
+
+            return;
+        }
+
+        // helpers can be picked up after everything's done, so what they touch can't live on this stack
+        struct Shared
+        {
+            std::atomic<std::size_t> next = 0;
+            std::atomic<std::size_t> finished = 0;
+            std::mutex mutex;
+            std::condition_variable done;
+            std::exception_ptr error;
+        };
+
+        auto shared = std::make_shared<Shared>();
+        const auto* work = &task;
+
+        // indices are claimed from a shared counter, so the caller keeps working instead of blocking
+        auto run = [shared, work, count]()
+        {
+            std::size_t index;
+
+            while ((index = shared->next.fetch_add(1)) < count)
+            {
+                try
+                {
+                    (*work)(index);
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock(shared->mutex);
+                    if (!shared->error) { shared->error = std::current_exception(); }
+                }
+
+                if (shared->finished.fetch_add(1) + 1 == count)
+                {
+                    std::lock_guard<std::mutex> lock(shared->mutex);
+                    shared->done.notify_all();
+                }
+            }
+        };
+
+        std::size_t helpers = std::min(m_Threads.size(), count - 1);
+
+        for (std::size_t i = 0; i < helpers; ++i)
+        {
+            Enqueue(run);
+        }
+
+        run();
+
+        std::unique_lock<std::mutex> lock(shared->mutex);
+        shared->done.wait(lock, [&]() { return shared->finished.load() == count; });
+
+        if (shared->error) { std::rethrow_exception(shared->error); }
+    }
+}
\ No newline at end of file
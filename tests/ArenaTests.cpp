@@ -0,0 +1,138 @@
+#include <limits>
+#include <new>
+#include <vector>
+
+#include "TestCheck.h"
+#include "VkTest/Arena.h"
+
+using namespace VkTest;
+
+namespace
+{
+    // counts what the arena takes from and gives back to upstream
+    class CountingResource : public std::pmr::memory_resource
+    {
+    public:
+        int allocations = 0;
+        int deallocations = 0;
+    protected:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override
+        {
+            ++allocations;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void* memory, std::size_t bytes, std::size_t alignment) override
+        {
+            ++deallocations;
+            std::pmr::new_delete_resource()->deallocate(memory, bytes, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+    };
+
+    void TestAlignment()
+    {
+        CountingResource upstream;
+        Arena arena(1024, &upstream);
+
+        (void)arena.allocate(1, 1);
+
+        for (std::size_t alignment = 1; alignment <= 256; alignment *= 2)
+        {
+            auto address = reinterpret_cast<std::uintptr_t>(arena.allocate(3, alignment));
+            VKTEST_CHECK(address % alignment == 0);
+        }
+
+        // larger than a block, gets a block of its own that's still aligned
+        auto address = reinterpret_cast<std::uintptr_t>(arena.allocate(4096, 512));
+        VKTEST_CHECK(address % 512 == 0);
+        VKTEST_CHECK(arena.GetCapacity() >= 1024 + 4096);
+    }
+
+    void TestRewind()
+    {
+        CountingResource upstream;
+        Arena arena(256, &upstream);
+
+        void* first = arena.allocate(64, 8);
+        Arena::Marker marker = arena.GetMarker();
+        void* second = arena.allocate(64, 8);
+
+        // spill into later blocks, then come back to the marker in the first one
+        for (int i = 0; i < 10; ++i) { (void)arena.allocate(200, 8); }
+
+        VKTEST_CHECK(upstream.allocations > 1);
+        arena.Rewind(marker);
+        VKTEST_CHECK(arena.allocate(64, 8) == second);
+
+        arena.Reset();
+        VKTEST_CHECK(arena.allocate(64, 8) == first);
+
+        {
+            ArenaScope scope(arena);
+            (void)arena.allocate(128, 8);
+        }
+
+        VKTEST_CHECK(arena.allocate(64, 8) == second);
+    }
+
+    // a repeated workload is served from the blocks of the first run
+    void TestReuse()
+    {
+        CountingResource upstream;
+        Arena arena(512, &upstream);
+        std::size_t capacity = 0;
+        int allocations = 0;
+
+        for (int frame = 0; frame < 5; ++frame)
+        {
+            arena.Reset();
+            std::pmr::vector<int> values(&arena);
+
+            for (int i = 0; i < 1000; ++i) { values.push_back(i); }
+
+            if (frame == 0)
+            {
+                capacity = arena.GetCapacity();
+                allocations = upstream.allocations;
+            }
+        }
+
+        VKTEST_CHECK(arena.GetCapacity() == capacity);
+        VKTEST_CHECK(upstream.allocations == allocations);
+        VKTEST_CHECK(upstream.deallocations == 0);
+    }
+
+    void TestOverflow()
+    {
+        CountingResource upstream;
+        std::uint64_t before = Arena::GetUpstreamAllocationCount();
+
+        {
+            Arena arena(256, &upstream);
+            void* first = arena.allocate(16, 16);
+
+            // the size plus alignment padding would wrap
+            VKTEST_CHECK(Test::Throws([&arena]() { (void)arena.allocate(std::numeric_limits<std::size_t>::max(), 16); }));
+            VKTEST_CHECK(Test::Throws([&arena]() { (void)arena.allocate(std::numeric_limits<std::size_t>::max() - 8, 16); }));
+            VKTEST_CHECK(upstream.allocations == 1);
+
+            // a failed allocation leaves the arena usable
+            arena.Reset();
+            VKTEST_CHECK(arena.allocate(16, 16) == first);
+        }
+
+        VKTEST_CHECK(upstream.deallocations == upstream.allocations);
+        VKTEST_CHECK(Arena::GetUpstreamAllocationCount() == before + 1);
+    }
+}
+
+int main()
+{
+    TestAlignment();
+    TestRewind();
+    TestReuse();
+    TestOverflow();
+    return Test::Result();
+}
\ No newline at end of file
@@ -0,0 +1,138 @@
+#include <limits>
+
+#include "TestCheck.h"
+#include "VkTest/CaptureFormat.h"
+
+using namespace VkTest;
+
+namespace
+{
+    struct Pair
+    {
+        std::uint32_t first;
+        float second;
+    };
+
+    void TestRoundTrip()
+    {
+        CaptureWriter writer;
+        Pair pairs[] = {{1, 0.5f}, {2, 1.5f}, {3, 2.5f}};
+
+        writer.Begin(CaptureOp::Draw);
+        writer.Write(std::uint64_t(42));
+        writer.WriteArray(pairs, 3);
+        writer.WriteString("main");
+        writer.WriteArray<std::uint32_t>(nullptr, 5);
+        writer.End();
+        writer.Begin(CaptureOp::Present);
+        writer.End();
+
+        const auto& data = writer.GetData();
+        CaptureReader reader(data.data(), data.size());
+        CaptureOp op;
+
+        CaptureReader draw = reader.ReadRecord(op);
+        VKTEST_CHECK(op == CaptureOp::Draw);
+        VKTEST_CHECK(draw.Read<std::uint64_t>() == 42);
+
+        std::vector<Pair> read = draw.ReadArray<Pair>();
+        VKTEST_CHECK(read.size() == 3 && read[2].first == 3 && read[2].second == 2.5f);
+        VKTEST_CHECK(draw.ReadString() == "main");
+        // null is written as an empty array whatever count it came with
+        VKTEST_CHECK(draw.ReadArray<std::uint32_t>().empty());
+        VKTEST_CHECK(draw.IsAtEnd());
+
+        CaptureReader present = reader.ReadRecord(op);
+        VKTEST_CHECK(op == CaptureOp::Present);
+        VKTEST_CHECK(present.IsAtEnd());
+        VKTEST_CHECK(reader.IsAtEnd());
+    }
+
+    void TestTruncatedRead()
+    {
+        std::uint8_t bytes[3] = {};
+        CaptureReader reader(bytes, sizeof(bytes));
+
+        VKTEST_CHECK(Test::Throws([&reader]() { reader.Read<std::uint32_t>(); }));
+        VKTEST_CHECK(reader.Read<std::uint16_t>() == 0);
+        VKTEST_CHECK(Test::Throws([&reader]() { reader.Read<std::uint16_t>(); }));
+        VKTEST_CHECK(reader.Read<std::uint8_t>() == 0);
+        VKTEST_CHECK(reader.IsAtEnd());
+        VKTEST_CHECK(Test::Throws([&reader]() { reader.Read<std::uint8_t>(); }));
+    }
+
+    // a count is checked against the bytes left before anything is sized from it
+    void TestCounts()
+    {
+        CaptureWriter writer;
+        writer.Write(std::numeric_limits<std::uint32_t>::max());
+        writer.Write(std::uint32_t(0));
+
+        const auto& huge = writer.GetData();
+        CaptureReader hugeReader(huge.data(), huge.size());
+        VKTEST_CHECK(Test::Throws([&hugeReader]() { hugeReader.ReadArray<std::uint64_t>(); }));
+
+        // two elements promised, one and a half there
+        writer.Clear();
+        writer.Write(std::uint32_t(2));
+        writer.Write(std::uint32_t(7));
+        writer.Write(std::uint16_t(8));
+
+        const auto& shortArray = writer.GetData();
+        CaptureReader shortReader(shortArray.data(), shortArray.size());
+        VKTEST_CHECK(Test::Throws([&shortReader]() { shortReader.ReadArray<std::uint32_t>(); }));
+
+        CaptureReader countReader(shortArray.data(), shortArray.size());
+        VKTEST_CHECK(countReader.ReadCount(sizeof(std::uint16_t)) == 2);
+
+        CaptureReader stringReader(shortArray.data(), shortArray.size());
+        VKTEST_CHECK(stringReader.ReadString().size() == 2);
+    }
+
+    void TestRecords()
+    {
+        CaptureWriter writer;
+        writer.Write(static_cast<std::uint16_t>(CaptureOp::Count));
+        writer.Write(std::uint32_t(0));
+
+        const auto& unknown = writer.GetData();
+        CaptureReader unknownReader(unknown.data(), unknown.size());
+        CaptureOp op;
+        VKTEST_CHECK(Test::Throws([&]() { unknownReader.ReadRecord(op); }));
+
+        // a payload size past the end of the capture
+        writer.Clear();
+        writer.Write(static_cast<std::uint16_t>(CaptureOp::Draw));
+        writer.Write(std::uint32_t(16));
+        writer.Write(std::uint64_t(0));
+
+        const auto& truncated = writer.GetData();
+        CaptureReader truncatedReader(truncated.data(), truncated.size());
+        VKTEST_CHECK(Test::Throws([&]() { truncatedReader.ReadRecord(op); }));
+
+        // a record's reader stops at its own payload even when more of the capture follows
+        writer.Clear();
+        writer.Begin(CaptureOp::SetViewport);
+        writer.Write(std::uint32_t(5));
+        writer.End();
+        writer.Begin(CaptureOp::SetScissor);
+        writer.Write(std::uint32_t(6));
+        writer.End();
+
+        const auto& records = writer.GetData();
+        CaptureReader reader(records.data(), records.size());
+        CaptureReader viewport = reader.ReadRecord(op);
+        VKTEST_CHECK(viewport.Read<std::uint32_t>() == 5);
+        VKTEST_CHECK(Test::Throws([&viewport]() { viewport.Read<std::uint32_t>(); }));
+        VKTEST_CHECK(reader.ReadRecord(op).Read<std::uint32_t>() == 6 && op == CaptureOp::SetScissor);
+    }
+}
+
+int main()
+{
+    TestRoundTrip();
+    TestTruncatedRead();
+    TestCounts();
+    TestRecords();
+    return Test::Result();
+}
\ No newline at end of file
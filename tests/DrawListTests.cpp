@@ -0,0 +1,157 @@
+#include <cmath>
+#include <limits>
+#include <random>
+
+#include "TestCheck.h"
+#include "VkTest/DrawList.h"
+
+using namespace VkTest;
+
+namespace
+{
+    constexpr float kFarPlane = 100.0f;
+
+    Draw MakeDraw(std::uint16_t pipeline, std::uint16_t material, bool transparent, float viewDepth, std::uint32_t firstInstance = 0)
+    {
+        return {pipeline, material, transparent, viewDepth, 3, 1, 0, firstInstance};
+    }
+
+    void TestKeyLayout()
+    {
+        std::uint64_t opaque = DrawList::MakeKey(MakeDraw(0x1234, 0xABCD, false, kFarPlane), kFarPlane);
+        VKTEST_CHECK((opaque >> 62) == 0);
+        VKTEST_CHECK(((opaque >> 48) & 0x3FFF) == 0x1234);
+        VKTEST_CHECK(((opaque >> 32) & 0xFFFF) == 0xABCD);
+        VKTEST_CHECK(((opaque >> 8) & 0xFFFFFF) == 0xFFFFFF);
+        VKTEST_CHECK((opaque & 0xFF) == 0);
+
+        std::uint64_t transparent = DrawList::MakeKey(MakeDraw(0x1234, 0xABCD, true, 0.0f), kFarPlane);
+        VKTEST_CHECK((transparent >> 62) == 1);
+        VKTEST_CHECK(((transparent >> 38) & 0xFFFFFF) == 0xFFFFFF);
+        VKTEST_CHECK(((transparent >> 24) & 0x3FFF) == 0x1234);
+        VKTEST_CHECK(((transparent >> 8) & 0xFFFF) == 0xABCD);
+        VKTEST_CHECK((transparent & 0xFF) == 0);
+
+        // depth is clamped to the far plane instead of spilling into the material bits
+        VKTEST_CHECK(DrawList::MakeKey(MakeDraw(0, 0, false, -5.0f), kFarPlane) == 0);
+        VKTEST_CHECK(DrawList::MakeKey(MakeDraw(0, 0, false, 1000.0f), kFarPlane) == DrawList::MakeKey(MakeDraw(0, 0, false, kFarPlane), kFarPlane));
+
+        VKTEST_CHECK(!Test::Throws([]() { DrawList::MakeKey(MakeDraw(0x3FFF, 0, false, 0.0f), kFarPlane); }));
+        VKTEST_CHECK(Test::Throws([]() { DrawList::MakeKey(MakeDraw(0x4000, 0, false, 0.0f), kFarPlane); }));
+        VKTEST_CHECK(Test::Throws([]() { DrawList::MakeKey(MakeDraw(0xFFFF, 0, true, 0.0f), kFarPlane); }));
+    }
+
+    // NaN can't be clamped or converted, it sorts as far as the far plane does
+    void TestNaNDepth()
+    {
+        float nan = std::numeric_limits<float>::quiet_NaN();
+        VKTEST_CHECK(DrawList::MakeKey(MakeDraw(1, 2, false, nan), kFarPlane) == DrawList::MakeKey(MakeDraw(1, 2, false, kFarPlane), kFarPlane));
+        VKTEST_CHECK(DrawList::MakeKey(MakeDraw(1, 2, true, nan), kFarPlane) == DrawList::MakeKey(MakeDraw(1, 2, true, kFarPlane), kFarPlane));
+
+        ThreadPool pool(1);
+        DrawList list(kFarPlane);
+        list.Add(MakeDraw(0, 0, false, nan, 0));
+        list.Add(MakeDraw(0, 0, false, 10.0f, 1));
+        list.Add(MakeDraw(0, 0, true, nan, 2));
+        list.Add(MakeDraw(0, 0, true, 10.0f, 3));
+        list.Sort(pool);
+
+        VKTEST_CHECK(list.GetSize() == 4);
+        VKTEST_CHECK(list[0].firstInstance == 1);
+        VKTEST_CHECK(list[1].firstInstance == 0);
+        // transparents go back to front, so the far NaN one comes first
+        VKTEST_CHECK(list[2].firstInstance == 2);
+        VKTEST_CHECK(list[3].firstInstance == 3);
+    }
+
+    void TestOrder()
+    {
+        ThreadPool pool(1);
+        DrawList list(kFarPlane);
+        list.Add(MakeDraw(0, 0, true, 20.0f, 0));
+        list.Add(MakeDraw(1, 0, false, 5.0f, 1));
+        list.Add(MakeDraw(0, 1, false, 1.0f, 2));
+        list.Add(MakeDraw(0, 0, false, 50.0f, 3));
+        list.Add(MakeDraw(0, 0, true, 80.0f, 4));
+        list.Add(MakeDraw(0, 0, false, 2.0f, 5));
+        list.Sort(pool);
+
+        VKTEST_CHECK(list.GetOpaqueCount() == 4);
+
+        // opaques by pipeline, then material, then front to back. transparents after them, back to front
+        std::uint32_t expected[] = {5, 3, 2, 1, 4, 0};
+
+        for (std::size_t i = 0; i < list.GetSize(); ++i)
+        {
+            VKTEST_CHECK(list[i].firstInstance == expected[i]);
+        }
+
+        list.Clear();
+        VKTEST_CHECK(list.GetSize() == 0 && list.GetOpaqueCount() == 0);
+    }
+
+    // enough draws to be split into chunks across the pool, equal keys have to keep their insertion order
+    void TestStability()
+    {
+        ThreadPool pool(3);
+        DrawList list(kFarPlane);
+        std::mt19937 random(1234);
+        constexpr std::uint32_t count = 50000;
+
+        for (std::uint32_t i = 0; i < count; ++i)
+        {
+            // few distinct keys, so most draws share theirs with many others
+            auto pipeline = static_cast<std::uint16_t>(random() % 3);
+            auto material = static_cast<std::uint16_t>(random() % 4);
+            float depth = static_cast<float>(random() % 5) * 10.0f;
+            list.Add(MakeDraw(pipeline, material, random() % 4 == 0, depth, i));
+        }
+
+        list.Sort(pool);
+        VKTEST_CHECK(list.GetSize() == count);
+
+        bool sorted = true;
+        bool stable = true;
+
+        for (std::size_t i = 1; i < list.GetSize(); ++i)
+        {
+            std::uint64_t previous = DrawList::MakeKey(list[i - 1], kFarPlane);
+            std::uint64_t current = DrawList::MakeKey(list[i], kFarPlane);
+            sorted = sorted && previous <= current;
+            stable = stable && (previous != current || list[i - 1].firstInstance < list[i].firstInstance);
+        }
+
+        VKTEST_CHECK(sorted);
+        VKTEST_CHECK(stable);
+
+        for (std::size_t i = 0; i < list.GetSize(); ++i)
+        {
+            if (list[i].transparent != (i >= list.GetOpaqueCount()))
+            {
+                VKTEST_CHECK(!"opaques and transparents are interleaved");
+                break;
+            }
+        }
+
+        // identical keys skip every byte pass and leave the list as it was added
+        list.Clear();
+
+        for (std::uint32_t i = 0; i < 10000; ++i) { list.Add(MakeDraw(2, 7, false, 3.0f, i)); }
+
+        list.Sort(pool);
+        bool unchanged = true;
+
+        for (std::uint32_t i = 0; i < list.GetSize(); ++i) { unchanged = unchanged && list[i].firstInstance == i; }
+
+        VKTEST_CHECK(unchanged);
+    }
+}
+
+int main()
+{
+    TestKeyLayout();
+    TestNaNDepth();
+    TestOrder();
+    TestStability();
+    return Test::Result();
+}
\ No newline at end of file
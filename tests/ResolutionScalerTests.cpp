@@ -0,0 +1,79 @@
+#include "TestCheck.h"
+#include "VkTest/ResolutionScaler.h"
+
+using namespace VkTest;
+
+namespace
+{
+    // starts at the max scale and stays there while frames land inside the dead band
+    void TestDeadBand()
+    {
+        ResolutionScaler scaler(16.0f, 0.5f, 1.0f);
+
+        for (int i = 0; i < 100; ++i) { scaler.AddFrameTime(i % 2 == 0 ? 16.5f : 15.5f); }
+
+        VKTEST_CHECK(scaler.GetScale() == 1.0f);
+
+        // a single spike is smoothed away before it leaves the band
+        scaler.AddFrameTime(20.0f);
+        VKTEST_CHECK(scaler.GetScale() == 1.0f);
+    }
+
+    void TestScalesDownAndClamps()
+    {
+        ResolutionScaler scaler(16.0f, 0.5f, 1.0f);
+        float previous = scaler.GetScale();
+        bool monotonic = true;
+
+        for (int i = 0; i < 500; ++i)
+        {
+            scaler.AddFrameTime(100.0f);
+            monotonic = monotonic && scaler.GetScale() <= previous;
+            previous = scaler.GetScale();
+        }
+
+        VKTEST_CHECK(monotonic);
+        VKTEST_CHECK(scaler.GetScale() == 0.5f);
+        VKTEST_CHECK(scaler.GetAverageFrameTime() > 90.0f);
+    }
+
+    void TestRecoversToMax()
+    {
+        ResolutionScaler scaler(16.0f, 0.25f, 0.9f);
+        VKTEST_CHECK(scaler.GetScale() == 0.9f);
+
+        for (int i = 0; i < 200; ++i) { scaler.AddFrameTime(64.0f); }
+
+        VKTEST_CHECK(scaler.GetScale() < 0.9f);
+
+        // fast frames push it back up, but never past the max
+        for (int i = 0; i < 500; ++i) { scaler.AddFrameTime(1.0f); }
+
+        VKTEST_CHECK(scaler.GetScale() == 0.9f);
+    }
+
+    void TestRenderExtent()
+    {
+        ResolutionScaler scaler(16.0f, 0.5f, 1.0f);
+        VkExtent2D full = scaler.GetRenderExtent({1920, 1080});
+        VKTEST_CHECK(full.width == 1920 && full.height == 1080);
+
+        for (int i = 0; i < 500; ++i) { scaler.AddFrameTime(100.0f); }
+
+        VkExtent2D half = scaler.GetRenderExtent({1920, 1080});
+        VKTEST_CHECK(half.width == 960 && half.height == 540);
+
+        // never rounds down to an empty extent
+        VkExtent2D tiny = scaler.GetRenderExtent({1, 1});
+        VKTEST_CHECK(tiny.width == 1 && tiny.height == 1);
+    }
+}
+
+int main()
+{
+    TestDeadBand();
+    TestScalesDownAndClamps();
+    TestRecoversToMax();
+    TestRenderExtent();
+    return Test::Result();
+}
\ No newline at end of file
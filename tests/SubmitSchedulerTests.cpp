@@ -0,0 +1,267 @@
+#include <vector>
+#include <string>
+
+#include "TestCheck.h"
+#include "VkTest/SubmitScheduler.h"
+#include "VkTest/ComputeQueue.h"
+
+using namespace VkTest;
+using Test::MakeHandle;
+
+namespace
+{
+    struct RecordedSubmit
+    {
+        std::uint32_t commandBufferCount;
+        std::vector<VkSemaphoreSubmitInfo> waits;
+        std::vector<VkSemaphoreSubmitInfo> signals;
+    };
+
+    struct RecordedQueueSubmit
+    {
+        VkQueue queue;
+        std::vector<RecordedSubmit> submits;
+    };
+
+    // everything the fakes saw, reset by each test
+    std::uintptr_t g_NextHandle = 1;
+    std::vector<RecordedQueueSubmit> g_QueueSubmits;
+    std::vector<std::string> g_Commands;
+
+    VKAPI_ATTR VkResult VKAPI_CALL FakeCreateSemaphore(VkDevice, const VkSemaphoreCreateInfo*, const VkAllocationCallbacks*, VkSemaphore* pSemaphore)
+    {
+        *pSemaphore = MakeHandle<VkSemaphore>(g_NextHandle++);
+        return VK_SUCCESS;
+    }
+
+    VKAPI_ATTR void VKAPI_CALL FakeDestroySemaphore(VkDevice, VkSemaphore, const VkAllocationCallbacks*) {}
+
+    VKAPI_ATTR VkResult VKAPI_CALL FakeGetSemaphoreCounterValue(VkDevice, VkSemaphore, std::uint64_t* pValue)
+    {
+        *pValue = 0;
+        return VK_SUCCESS;
+    }
+
+    VKAPI_ATTR VkResult VKAPI_CALL FakeWaitSemaphores(VkDevice, const VkSemaphoreWaitInfo*, std::uint64_t) { return VK_SUCCESS; }
+
+    VKAPI_ATTR VkResult VKAPI_CALL FakeQueueSubmit2(VkQueue queue, std::uint32_t submitCount, const VkSubmitInfo2* pSubmits, VkFence)
+    {
+        RecordedQueueSubmit& recorded = g_QueueSubmits.emplace_back();
+        recorded.queue = queue;
+
+        for (std::uint32_t i = 0; i < submitCount; ++i)
+        {
+            RecordedSubmit& submit = recorded.submits.emplace_back();
+            submit.commandBufferCount = pSubmits[i].commandBufferInfoCount;
+            submit.waits.assign(pSubmits[i].pWaitSemaphoreInfos, pSubmits[i].pWaitSemaphoreInfos + pSubmits[i].waitSemaphoreInfoCount);
+            submit.signals.assign(pSubmits[i].pSignalSemaphoreInfos, pSubmits[i].pSignalSemaphoreInfos + pSubmits[i].signalSemaphoreInfoCount);
+        }
+
+        return VK_SUCCESS;
+    }
+
+    VKAPI_ATTR VkResult VKAPI_CALL FakeCreateCommandPool(VkDevice, const VkCommandPoolCreateInfo*, const VkAllocationCallbacks*, VkCommandPool* pCommandPool)
+    {
+        *pCommandPool = MakeHandle<VkCommandPool>(g_NextHandle++);
+        return VK_SUCCESS;
+    }
+
+    VKAPI_ATTR void VKAPI_CALL FakeDestroyCommandPool(VkDevice, VkCommandPool, const VkAllocationCallbacks*) {}
+
+    VKAPI_ATTR VkResult VKAPI_CALL FakeAllocateCommandBuffers(VkDevice, const VkCommandBufferAllocateInfo* pAllocateInfo, VkCommandBuffer* pCommandBuffers)
+    {
+        for (std::uint32_t i = 0; i < pAllocateInfo->commandBufferCount; ++i)
+        {
+            pCommandBuffers[i] = MakeHandle<VkCommandBuffer>(g_NextHandle++);
+        }
+
+        return VK_SUCCESS;
+    }
+
+    VKAPI_ATTR VkResult VKAPI_CALL FakeBeginCommandBuffer(VkCommandBuffer, const VkCommandBufferBeginInfo*) { return VK_SUCCESS; }
+    VKAPI_ATTR VkResult VKAPI_CALL FakeEndCommandBuffer(VkCommandBuffer) { return VK_SUCCESS; }
+    VKAPI_ATTR VkResult VKAPI_CALL FakeResetCommandBuffer(VkCommandBuffer, VkCommandBufferResetFlags) { return VK_SUCCESS; }
+
+    VKAPI_ATTR void VKAPI_CALL FakeCmdPipelineBarrier(VkCommandBuffer, VkPipelineStageFlags, VkPipelineStageFlags, VkDependencyFlags, std::uint32_t, const VkMemoryBarrier*,
+        std::uint32_t, const VkBufferMemoryBarrier*, std::uint32_t, const VkImageMemoryBarrier*)
+    {
+        g_Commands.push_back("barrier");
+    }
+
+    void InstallFakes()
+    {
+        vkCreateSemaphore = FakeCreateSemaphore;
+        vkDestroySemaphore = FakeDestroySemaphore;
+        vkGetSemaphoreCounterValue = FakeGetSemaphoreCounterValue;
+        vkWaitSemaphores = FakeWaitSemaphores;
+        vkQueueSubmit2 = FakeQueueSubmit2;
+        vkCreateCommandPool = FakeCreateCommandPool;
+        vkDestroyCommandPool = FakeDestroyCommandPool;
+        vkAllocateCommandBuffers = FakeAllocateCommandBuffers;
+        vkBeginCommandBuffer = FakeBeginCommandBuffer;
+        vkEndCommandBuffer = FakeEndCommandBuffer;
+        vkResetCommandBuffer = FakeResetCommandBuffer;
+        vkCmdPipelineBarrier = FakeCmdPipelineBarrier;
+    }
+
+    void Reset()
+    {
+        g_QueueSubmits.clear();
+        g_Commands.clear();
+    }
+
+    bool Contains(const std::vector<VkSemaphoreSubmitInfo>& infos, VkSemaphore semaphore, std::uint64_t value)
+    {
+        for (const auto& info : infos)
+        {
+            if (info.semaphore == semaphore && info.value == value) { return true; }
+        }
+
+        return false;
+    }
+
+    // a graphics submit waiting on a dispatch from a separate compute queue
+    void TestCrossQueueWait()
+    {
+        Reset();
+        VkDevice device = MakeHandle<VkDevice>(g_NextHandle++);
+        VkQueue graphicsQueue = MakeHandle<VkQueue>(g_NextHandle++);
+        VkQueue computeQueue = MakeHandle<VkQueue>(g_NextHandle++);
+
+        SubmitScheduler scheduler(device);
+        SubmitScheduler::QueueId graphicsId = scheduler.AddQueue(graphicsQueue);
+        SubmitScheduler::QueueId computeId = scheduler.AddQueue(computeQueue);
+        VKTEST_CHECK(graphicsId != computeId);
+        VKTEST_CHECK(!scheduler.IsShared(computeId));
+
+        {
+            ComputeQueue compute(device, scheduler, computeId, 1);
+            std::uint64_t value = compute.Dispatch([](VkCommandBuffer) { g_Commands.push_back("dispatch"); });
+            VKTEST_CHECK(value == 1);
+            VKTEST_CHECK(g_Commands == std::vector<std::string>{"dispatch"});
+
+            SubmitBatch batch(scheduler.GetBatchMemory());
+            batch.commandBuffers.push_back(MakeHandle<VkCommandBuffer>(g_NextHandle++));
+            batch.waits.push_back({compute.GetTimelineSemaphore(), value, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT});
+            scheduler.Enqueue(graphicsId, std::move(batch));
+            scheduler.Flush();
+
+            VKTEST_CHECK(g_QueueSubmits.size() == 2);
+            VKTEST_CHECK(scheduler.GetLastSubmitCount() == 2);
+
+            for (const auto& queueSubmit : g_QueueSubmits)
+            {
+                VKTEST_CHECK(queueSubmit.submits.size() == 1);
+                const RecordedSubmit& submit = queueSubmit.submits.front();
+
+                if (queueSubmit.queue == computeQueue)
+                {
+                    VKTEST_CHECK(submit.waits.empty());
+                    VKTEST_CHECK(Contains(submit.signals, compute.GetTimelineSemaphore(), value));
+                }
+                else
+                {
+                    VKTEST_CHECK(Contains(submit.waits, compute.GetTimelineSemaphore(), value));
+                    VKTEST_CHECK(Contains(submit.signals, scheduler.GetTimelineSemaphore(graphicsId), 1));
+                }
+            }
+        }
+    }
+
+    // with one queue for both a wait on the shared timeline would come before its own signal in the same submit
+    void TestSharedQueueWait()
+    {
+        Reset();
+        VkDevice device = MakeHandle<VkDevice>(g_NextHandle++);
+        VkQueue queue = MakeHandle<VkQueue>(g_NextHandle++);
+
+        SubmitScheduler scheduler(device);
+        SubmitScheduler::QueueId graphicsId = scheduler.AddQueue(queue);
+        SubmitScheduler::QueueId computeId = scheduler.AddQueue(queue);
+        VKTEST_CHECK(graphicsId == computeId);
+        VKTEST_CHECK(scheduler.IsShared(computeId));
+
+        {
+            ComputeQueue compute(device, scheduler, computeId, 0);
+            VkSemaphore timeline = scheduler.GetTimelineSemaphore(graphicsId);
+            std::uint64_t value = compute.Dispatch([](VkCommandBuffer) { g_Commands.push_back("dispatch"); });
+            VKTEST_CHECK(value == 1);
+            VKTEST_CHECK((g_Commands == std::vector<std::string>{"barrier", "dispatch", "barrier"}));
+
+            SubmitBatch batch(scheduler.GetBatchMemory());
+            batch.commandBuffers.push_back(MakeHandle<VkCommandBuffer>(g_NextHandle++));
+            batch.waits.push_back({timeline, value, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT});
+            scheduler.Enqueue(graphicsId, std::move(batch));
+            scheduler.Flush();
+
+            VKTEST_CHECK(g_QueueSubmits.size() == 1);
+            VKTEST_CHECK(scheduler.GetSubmittedValue(graphicsId) == value);
+
+            if (g_QueueSubmits.size() == 1)
+            {
+                // the dropped wait doesn't split the batches either
+                const auto& submits = g_QueueSubmits.front().submits;
+                VKTEST_CHECK(submits.size() == 1);
+
+                for (const auto& submit : submits)
+                {
+                    VKTEST_CHECK(submit.waits.empty());
+                }
+
+                VKTEST_CHECK(submits.front().commandBufferCount == 2);
+                VKTEST_CHECK(Contains(submits.back().signals, timeline, value));
+            }
+        }
+    }
+
+    // a batch with a foreign wait starts a new VkSubmitInfo2 so the wait doesn't hold back earlier work
+    void TestBatchGrouping()
+    {
+        Reset();
+        VkDevice device = MakeHandle<VkDevice>(g_NextHandle++);
+        VkQueue queue = MakeHandle<VkQueue>(g_NextHandle++);
+        VkSemaphore foreign = MakeHandle<VkSemaphore>(g_NextHandle++);
+
+        SubmitScheduler scheduler(device);
+        SubmitScheduler::QueueId id = scheduler.AddQueue(queue);
+
+        for (int i = 0; i < 3; ++i)
+        {
+            SubmitBatch batch(scheduler.GetBatchMemory());
+            batch.commandBuffers.push_back(MakeHandle<VkCommandBuffer>(g_NextHandle++));
+
+            if (i == 1) { batch.waits.push_back({foreign, 7, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT}); }
+
+            scheduler.Enqueue(id, std::move(batch));
+        }
+
+        scheduler.Flush();
+        VKTEST_CHECK(g_QueueSubmits.size() == 1);
+
+        if (g_QueueSubmits.size() == 1)
+        {
+            const auto& submits = g_QueueSubmits.front().submits;
+            VKTEST_CHECK(submits.size() == 2);
+            VKTEST_CHECK(submits.front().commandBufferCount == 1);
+            VKTEST_CHECK(submits.front().signals.empty());
+            VKTEST_CHECK(submits.back().commandBufferCount == 2);
+            VKTEST_CHECK(Contains(submits.back().waits, foreign, 7));
+            VKTEST_CHECK(Contains(submits.back().signals, scheduler.GetTimelineSemaphore(id), 1));
+        }
+
+        // nothing pending, nothing submitted and the timeline stays put
+        Reset();
+        scheduler.Flush();
+        VKTEST_CHECK(g_QueueSubmits.empty());
+        VKTEST_CHECK(scheduler.GetPendingValue(id) == 2);
+    }
+}
+
+int main()
+{
+    InstallFakes();
+    TestCrossQueueWait();
+    TestSharedQueueWait();
+    TestBatchGrouping();
+    return Test::Result();
+}
\ No newline at end of file
@@ -0,0 +1,131 @@
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <string>
+#include <stdexcept>
+
+#include "TestCheck.h"
+#include "VkTest/TaskGraph.h"
+
+using namespace VkTest;
+
+namespace
+{
+    // every task has to finish after all of its dependencies, whatever the pool does
+    void TestDependencyOrder(ThreadPool& pool)
+    {
+        for (int round = 0; round < 50; ++round)
+        {
+            TaskGraph graph;
+            std::atomic<int> clock = 0;
+            std::vector<std::atomic<int>> finished(8);
+            auto work = [&](std::size_t id) { return [&, id]() { finished[id] = ++clock; }; };
+
+            TaskGraph::TaskId a = graph.Add("a", work(0));
+            TaskGraph::TaskId b = graph.Add("b", work(1), {a});
+            TaskGraph::TaskId c = graph.Add("c", work(2), {a});
+            TaskGraph::TaskId d = graph.Add("d", work(3), {b, c});
+            TaskGraph::TaskId e = graph.Add("e", work(4));
+            TaskGraph::TaskId f = graph.Add("f", work(5), {e, b}, TaskGraph::Affinity::MainThread);
+            TaskGraph::TaskId g = graph.Add("g", work(6), {d, f});
+            TaskGraph::TaskId h = graph.Add("h", work(7), {g}, TaskGraph::Affinity::MainThread);
+            graph.Run(pool);
+
+            VKTEST_CHECK(clock == 8);
+            VKTEST_CHECK(finished[a] < finished[b] && finished[a] < finished[c]);
+            VKTEST_CHECK(finished[b] < finished[d] && finished[c] < finished[d]);
+            VKTEST_CHECK(finished[e] < finished[f] && finished[b] < finished[f]);
+            VKTEST_CHECK(finished[d] < finished[g] && finished[f] < finished[g]);
+            VKTEST_CHECK(finished[g] < finished[h]);
+        }
+    }
+
+    void TestMainThreadAffinity(ThreadPool& pool)
+    {
+        TaskGraph graph;
+        std::thread::id mainThread;
+        std::thread::id ranOn;
+        TaskGraph::TaskId worker = graph.Add("worker", []() {});
+        graph.Add("main", [&]() { ranOn = std::this_thread::get_id(); }, {worker}, TaskGraph::Affinity::MainThread);
+
+        mainThread = std::this_thread::get_id();
+        graph.Run(pool);
+        VKTEST_CHECK(ranOn == mainThread);
+    }
+
+    // the first failure comes out of Run and nothing that depends on it gets started
+    void TestErrorPropagation(ThreadPool& pool)
+    {
+        TaskGraph graph;
+        std::atomic<bool> dependentRan = false;
+        std::atomic<bool> independentRan = false;
+
+        TaskGraph::TaskId root = graph.Add("root", []() {});
+        TaskGraph::TaskId failing = graph.Add("failing", []() { throw std::runtime_error("task failed"); }, {root});
+        graph.Add("dependent", [&]() { dependentRan = true; }, {failing});
+        graph.Add("main dependent", [&]() { dependentRan = true; }, {failing}, TaskGraph::Affinity::MainThread);
+        graph.Add("independent", [&]() { independentRan = true; });
+
+        std::string message;
+
+        try
+        {
+            graph.Run(pool);
+        }
+        catch (const std::runtime_error& e)
+        {
+            message = e.what();
+        }
+
+        VKTEST_CHECK(message == "task failed");
+        VKTEST_CHECK(!dependentRan);
+        // it had no dependencies, so it was started before anything could fail
+        VKTEST_CHECK(independentRan);
+
+        // a rerun starts from a clean slate
+        dependentRan = false;
+        VKTEST_CHECK(Test::Throws([&]() { graph.Run(pool); }));
+        VKTEST_CHECK(!dependentRan);
+    }
+
+    void TestInvalidDependency()
+    {
+        TaskGraph graph;
+        TaskGraph::TaskId first = graph.Add("first", []() {});
+        VKTEST_CHECK(Test::Throws([&]() { graph.Add("self", []() {}, {first + 1}); }));
+        VKTEST_CHECK(Test::Throws([&]() { graph.Add("later", []() {}, {first + 5}); }));
+    }
+
+    void TestCriticalPath(ThreadPool& pool)
+    {
+        TaskGraph graph;
+        VKTEST_CHECK(graph.GetCriticalPath().empty());
+
+        TaskGraph::TaskId a = graph.Add("a", []() {});
+        TaskGraph::TaskId slow = graph.Add("slow", []() { std::this_thread::sleep_for(std::chrono::milliseconds(30)); }, {a});
+        TaskGraph::TaskId fast = graph.Add("fast", []() {}, {a});
+        TaskGraph::TaskId join = graph.Add("join", []() {}, {slow, fast});
+        graph.Run(pool);
+
+        VKTEST_CHECK((graph.GetCriticalPath() == std::vector<TaskGraph::TaskId>{a, slow, join}));
+    }
+
+    void TestEmptyGraph(ThreadPool& pool)
+    {
+        TaskGraph graph;
+        graph.Run(pool);
+        VKTEST_CHECK(graph.GetCriticalPath().empty());
+    }
+}
+
+int main()
+{
+    ThreadPool pool(3);
+    TestDependencyOrder(pool);
+    TestMainThreadAffinity(pool);
+    TestErrorPropagation(pool);
+    TestInvalidDependency();
+    TestCriticalPath(pool);
+    TestEmptyGraph(pool);
+    return Test::Result();
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#ifndef VKTEST_TEST_CHECK_H_
+#define VKTEST_TEST_CHECK_H_
+
+#include <iostream>
+#include <exception>
+#include <cstdint>
+#include <type_traits>
+
+namespace VkTest::Test
+{
+    inline int failures = 0;
+
+    inline void Check(bool passed, const char* expression, const char* file, int line)
+    {
+        if (!passed)
+        {
+            std::cerr << file << ':' << line << ": check failed: " << expression << '\n';
+            ++failures;
+        }
+    }
+
+    template<typename Function>
+    bool Throws(Function&& function)
+    {
+        try
+        {
+            function();
+        }
+        catch (const std::exception&)
+        {
+            return true;
+        }
+
+        return false;
+    }
+
+    // non-dispatchable handles are plain integers on 32-bit targets
+    template<typename Handle>
+    Handle MakeHandle(std::uintptr_t value) noexcept
+    {
+        if constexpr (std::is_pointer_v<Handle>) { return reinterpret_cast<Handle>(value); }
+        else { return static_cast<Handle>(value); }
+    }
+
+    inline int Result() noexcept
+    {
+        if (failures != 0)
+        {
+            std::cerr << failures << " check(s) failed.\n";
+            return 1;
+        }
+
+        return 0;
+    }
+}
+
+#define VKTEST_CHECK(expression) VkTest::Test::Check(static_cast<bool>(expression), #expression, __FILE__, __LINE__)
+
+#endif
\ No newline at end of file